@@ -0,0 +1,127 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Host microbenchmark for firing record decoding: the old chain of range
+// comparisons against the hex_table lookup used by the firmware.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "hexdecode.h"
+
+#define RECORDS 4096
+#define ROUNDS  2000
+
+static char hexdig(char ch)
+{
+    if (ch >= '0' && ch <= '9')
+        return ch - '0';
+    if (ch >= 'A' && ch <= 'F')
+        return ch - 'A' + 10;
+    if (ch >= 'a' && ch <= 'f')
+        return ch - 'a' + 10;
+    return 0;
+}
+
+static void compare_decode_spec(const char *spec, uint8_t *address,
+        uint8_t *rPrim, uint8_t *lPrim)
+{
+    *address = hexdig(spec[0]);
+    *rPrim = (hexdig(spec[1]) << 4) | hexdig(spec[2]);
+    *lPrim = (hexdig(spec[3]) << 4) | hexdig(spec[4]);
+}
+
+static char specs[RECORDS][6];
+
+// Keeps the decode loops from being optimised away
+static volatile unsigned sink;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef void (*decoder)(const char *, uint8_t *, uint8_t *, uint8_t *);
+
+static double run(decoder decode, unsigned *checksum)
+{
+    unsigned sum = 0;
+    double start = now();
+
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        for (int i = 0; i < RECORDS; i++)
+        {
+            uint8_t a, r, l;
+            decode(specs[i], &a, &r, &l);
+            sum += a + r + l;
+        }
+        sink = sum;
+    }
+
+    *checksum = sum;
+    return (double)RECORDS * ROUNDS / (now() - start);
+}
+
+int main(void)
+{
+    const char *digits = "0123456789ABCDEFabcdef";
+    unsigned seed = 1;
+
+    for (int i = 0; i < RECORDS; i++)
+    {
+        for (int j = 0; j < 5; j++)
+        {
+            seed = seed * 1103515245 + 12345;
+            specs[i][j] = digits[(seed >> 16) % 22];
+        }
+        specs[i][5] = 0;
+    }
+
+    // Every character has to decode the same way
+    for (int ch = 0; ch < 256; ch++)
+    {
+        if (hex_value(ch) != (uint8_t)hexdig(ch))
+        {
+            printf("mismatch for character %d\n", ch);
+            return 1;
+        }
+    }
+
+    unsigned compare_sum, table_sum;
+    double compare_rate = run(compare_decode_spec, &compare_sum);
+    double table_rate = run(hex_decode_spec, &table_sum);
+
+    if (compare_sum != table_sum)
+    {
+        printf("decoders disagree\n");
+        return 1;
+    }
+
+    printf("comparisons: %12.0f records/s\n", compare_rate);
+    printf("hex_table:   %12.0f records/s\n", table_rate);
+    printf("speedup:     %12.2fx\n", table_rate / compare_rate);
+
+    return 0;
+}
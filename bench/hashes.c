@@ -0,0 +1,130 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Host benchmark for whole-file verification hashes: the MD5 that md5
+// runs over every block against the table driven CRC-32 recv now keeps,
+// with djb2 for reference.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "md5.h"
+#include "crc32.h"
+
+#define BLOCK  1024
+#define BLOCKS 1024
+#define ROUNDS 16
+
+static unsigned char data[BLOCK * BLOCKS];
+
+// Keeps the hash loops from being optimised away
+static volatile uint32_t sink;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double run_md5(void)
+{
+    double start = now();
+
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        MD5_CTX md5;
+        unsigned char result[16];
+
+        MD5_Init(&md5);
+        for (int i = 0; i < BLOCKS; i++)
+            MD5_Update(&md5, data + i * BLOCK, BLOCK);
+        MD5_Final(result, &md5);
+        sink = result[0];
+    }
+
+    return (double)sizeof(data) * ROUNDS / (now() - start);
+}
+
+static double run_crc32(void)
+{
+    double start = now();
+
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        uint32_t crc = CRC32_INIT;
+
+        for (int i = 0; i < BLOCKS; i++)
+            crc = crc32_update(crc, data + i * BLOCK, BLOCK);
+        sink = crc32_final(crc);
+    }
+
+    return (double)sizeof(data) * ROUNDS / (now() - start);
+}
+
+static double run_djb2(void)
+{
+    double start = now();
+
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        uint32_t hash = 5381;
+
+        for (size_t i = 0; i < sizeof(data); i++)
+            hash = ((hash << 5) + hash) + data[i];
+        sink = hash;
+    }
+
+    return (double)sizeof(data) * ROUNDS / (now() - start);
+}
+
+int main(void)
+{
+    const char *check = "123456789";
+    unsigned seed = 1;
+
+    // The standard check value, so hosts can use zlib's crc32()
+    if (crc32_final(crc32_update(CRC32_INIT, check, strlen(check))) !=
+            0xCBF43926UL)
+    {
+        printf("crc32 check value mismatch\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(data); i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        data[i] = seed >> 16;
+    }
+
+    double md5_rate = run_md5();
+    double crc32_rate = run_crc32();
+    double djb2_rate = run_djb2();
+
+    printf("md5:     %10.1f MB/s\n", md5_rate / 1e6);
+    printf("crc32:   %10.1f MB/s\n", crc32_rate / 1e6);
+    printf("djb2:    %10.1f MB/s\n", djb2_rate / 1e6);
+    printf("speedup: %10.2fx crc32 over md5\n", crc32_rate / md5_rate);
+
+    return 0;
+}
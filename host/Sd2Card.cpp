@@ -0,0 +1,152 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+
+#include "SdFat/Sd2Card.h"
+
+#include "host.h"
+#include "profile.h"
+#include "trace.h"
+
+// Sd2Card on top of an image file, standing in for SdFat's SPI driver.
+// Only one card, so the image is a file static like the SPI bus is.
+
+const char *host_sd_image = NULL;
+
+static FILE *image = NULL;
+static uint32_t image_blocks = 0;
+static uint32_t stream_block;
+
+static bool image_seek(uint32_t block) {
+    return block < image_blocks &&
+           fseek(image, (long)block * 512, SEEK_SET) == 0;
+}
+
+bool Sd2Card::begin(uint8_t chipSelectPin, uint8_t sckDivisor) {
+    m_errorCode = m_type = 0;
+    m_chipSelectPin = chipSelectPin;
+    m_sckDivisor = sckDivisor;
+
+    if(!image && host_sd_image) {
+        image = fopen(host_sd_image, "r+b");
+
+        if(image) {
+            fseek(image, 0, SEEK_END);
+            image_blocks = ftell(image) / 512;
+        }
+    }
+
+    if(!image) {
+        error(SD_CARD_ERROR_CMD0);
+        return false;
+    }
+
+    type(SD_CARD_TYPE_SDHC);
+    return true;
+}
+
+uint32_t Sd2Card::cardSize() {
+    return image_blocks;
+}
+
+bool Sd2Card::erase(uint32_t firstBlock, uint32_t lastBlock) {
+    static const uint8_t zero[512] = { 0 };
+
+    for(uint32_t block = firstBlock; block <= lastBlock; block++) {
+        if(!writeBlock(block, zero)) {
+            error(SD_CARD_ERROR_ERASE);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Sd2Card::eraseSingleBlockEnable() {
+    return true;
+}
+
+bool Sd2Card::isBusy() {
+    return false;
+}
+
+bool Sd2Card::readBlock(uint32_t block, uint8_t* dst) {
+    uint16_t start = profile_begin();
+
+    trace(TRACE_SD_READ, block >> 16, block);
+
+    board_sd_block(m_sckDivisor);
+
+    bool ok = image && image_seek(block) && fread(dst, 1, 512, image) == 512;
+
+    profile_end(PROFILE_SD_READ, start);
+
+    if(!ok) {
+        error(SD_CARD_ERROR_CMD17);
+    }
+
+    return ok;
+}
+
+bool Sd2Card::readData(uint8_t *dst) {
+    return readBlock(stream_block++, dst);
+}
+
+bool Sd2Card::readRegister(uint8_t /*cmd*/, void* /*buf*/) {
+    error(SD_CARD_ERROR_READ_REG);
+    return false;
+}
+
+bool Sd2Card::readStart(uint32_t blockNumber) {
+    stream_block = blockNumber;
+    return image != NULL;
+}
+
+bool Sd2Card::readStop() {
+    return true;
+}
+
+bool Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t* src) {
+    board_sd_block(m_sckDivisor);
+
+    if(!image || !image_seek(blockNumber) ||
+            fwrite(src, 1, 512, image) != 512) {
+        error(SD_CARD_ERROR_CMD24);
+        return false;
+    }
+
+    return true;
+}
+
+bool Sd2Card::writeData(const uint8_t* src) {
+    return writeBlock(stream_block++, src);
+}
+
+bool Sd2Card::writeStart(uint32_t blockNumber, uint32_t /*eraseCount*/) {
+    stream_block = blockNumber;
+    return image != NULL;
+}
+
+bool Sd2Card::writeStop() {
+    fflush(image);
+    return true;
+}
@@ -0,0 +1,58 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _HOST_SERVO_H_
+#define _HOST_SERVO_H_
+
+#include <stdint.h>
+
+// Remembers the angle and nothing else
+class Servo {
+public:
+    Servo() : pin(0), angle(0) {}
+
+    uint8_t attach(int pin) {
+        this->pin = pin;
+        return 0;
+    }
+
+    void detach(void) {
+        pin = 0;
+    }
+
+    bool attached(void) {
+        return pin != 0;
+    }
+
+    void write(int angle) {
+        this->angle = angle;
+    }
+
+    int read(void) {
+        return angle;
+    }
+
+private:
+    int pin;
+    int angle;
+};
+
+#endif
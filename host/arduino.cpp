@@ -0,0 +1,391 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "host.h"
+
+HardwareSerial Serial;
+
+// Print
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+
+    while(size--) {
+        n += write(*buffer++);
+    }
+
+    return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str) {
+    return print((const char *)str);
+}
+
+size_t Print::print(const char *str) {
+    return write(str);
+}
+
+size_t Print::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char n, int base) {
+    return print((unsigned long)n, base);
+}
+
+size_t Print::print(int n, int base) {
+    return print((long)n, base);
+}
+
+size_t Print::print(unsigned int n, int base) {
+    return print((unsigned long)n, base);
+}
+
+size_t Print::print(long n, int base) {
+    if(base == 0) {
+        return write((uint8_t)n);
+    }
+
+    // Like the AVR core, only decimal is signed, and a long is 32 bits
+    if(base == DEC && n < 0) {
+        return print('-') + print_number(-(int32_t)n, DEC);
+    }
+
+    return print_number((uint32_t)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+    if(base == 0) {
+        return write((uint8_t)n);
+    }
+
+    return print_number((uint32_t)n, base);
+}
+
+size_t Print::print(double n, int digits) {
+    return print_float(n, digits);
+}
+
+size_t Print::println(void) {
+    return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *str) {
+    return print(str) + println();
+}
+
+size_t Print::println(const char *str) {
+    return print(str) + println();
+}
+
+size_t Print::println(char c) {
+    return print(c) + println();
+}
+
+size_t Print::println(unsigned char n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(int n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(unsigned int n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(long n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(unsigned long n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(double n, int digits) {
+    return print(n, digits) + println();
+}
+
+size_t Print::print_number(unsigned long n, uint8_t base) {
+    char buffer[33];
+    char *p = &buffer[sizeof(buffer) - 1];
+
+    *p = 0;
+
+    if(base < 2) {
+        base = 10;
+    }
+
+    do {
+        char digit = n % base;
+        n /= base;
+
+        *--p = digit < 10 ? digit + '0' : digit + 'A' - 10;
+    } while(n);
+
+    return write(p);
+}
+
+// Same rounding and digit by digit output as the AVR core, so the two
+// print the same text for the same value.
+size_t Print::print_float(double number, uint8_t digits) {
+    size_t n = 0;
+
+    if(isnan(number)) {
+        return print("nan");
+    }
+
+    if(isinf(number)) {
+        return print("inf");
+    }
+
+    if(number > 4294967040.0 || number < -4294967040.0) {
+        return print("ovf");
+    }
+
+    if(number < 0.0) {
+        n += print('-');
+        number = -number;
+    }
+
+    double rounding = 0.5;
+
+    for(uint8_t i = 0; i < digits; i++) {
+        rounding /= 10.0;
+    }
+
+    number += rounding;
+
+    unsigned long whole = (unsigned long)number;
+    double remainder = number - (double)whole;
+
+    n += print(whole);
+
+    if(digits > 0) {
+        n += print('.');
+    }
+
+    while(digits-- > 0) {
+        remainder *= 10.0;
+
+        int digit = int(remainder);
+
+        n += print(digit);
+        remainder -= digit;
+    }
+
+    return n;
+}
+
+// Stream
+
+size_t Stream::readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    unsigned long start = millis();
+
+    while(count < length) {
+        int c = read();
+
+        if(c >= 0) {
+            buffer[count++] = c;
+            start = millis();
+        } else if(millis() - start >= timeout || host_serial_finished()) {
+            break;
+        }
+    }
+
+    return count;
+}
+
+// Serial. The host's side of the line is stdin and stdout, the board
+// decides how fast bytes get across it.
+
+static uint8_t rx_buffer[4096];
+static size_t rx_head = 0;
+static size_t rx_tail = 0;
+static bool rx_closed = false;
+
+bool host_serial_blocking = false;
+
+static bool serial_fill(void) {
+    if(rx_head < rx_tail) {
+        return true;
+    }
+
+    if(rx_closed) {
+        return false;
+    }
+
+    // About to wait for the host, so let it see everything sent so far
+    fflush(stdout);
+
+    if(!host_serial_blocking) {
+        struct pollfd fd = { STDIN_FILENO, POLLIN, 0 };
+
+        if(poll(&fd, 1, 0) <= 0) {
+            return false;
+        }
+    }
+
+    ssize_t n = ::read(STDIN_FILENO, rx_buffer, sizeof(rx_buffer));
+
+    if(n <= 0) {
+        rx_closed = true;
+        return false;
+    }
+
+    rx_head = 0;
+    rx_tail = n;
+
+    return true;
+}
+
+void host_serial_inject(const char *text) {
+    size_t length = strlen(text);
+
+    if(rx_head == rx_tail) {
+        rx_head = rx_tail = 0;
+    }
+
+    if(length > sizeof(rx_buffer) - rx_tail) {
+        length = sizeof(rx_buffer) - rx_tail;
+    }
+
+    memcpy(&rx_buffer[rx_tail], text, length);
+    rx_tail += length;
+}
+
+bool host_serial_finished(void) {
+    return !serial_fill() && rx_closed;
+}
+
+void HardwareSerial::begin(unsigned long /*baud*/) {
+}
+
+// Also called from static destructors, so nothing virtual
+void HardwareSerial::end(void) {
+    fflush(stdout);
+}
+
+int HardwareSerial::available(void) {
+    return board_serial_arrived(serial_fill() ? rx_tail - rx_head : 0);
+}
+
+int HardwareSerial::read(void) {
+    if(available() == 0) {
+        return -1;
+    }
+
+    board_serial_received();
+
+    return rx_buffer[rx_head++];
+}
+
+int HardwareSerial::peek(void) {
+    return available() ? rx_buffer[rx_head] : -1;
+}
+
+void HardwareSerial::flush(void) {
+    fflush(stdout);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    board_serial_sent();
+    putchar(c);
+
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        write(buffer[i]);
+    }
+
+    return size;
+}
+
+// Pins
+
+static uint8_t pin_modes[HAL_PINS];
+static uint8_t pin_levels[HAL_PINS];
+static uint16_t analog_levels[HAL_PINS];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if(pin < HAL_PINS) {
+        pin_modes[pin] = mode;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if(pin < HAL_PINS) {
+        pin_levels[pin] = value ? HIGH : LOW;
+        board_pin_written(pin, pin_levels[pin]);
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < HAL_PINS ? pin_levels[pin] : LOW;
+}
+
+int analogRead(uint8_t pin) {
+    return pin < HAL_PINS ? analog_levels[pin] : 0;
+}
+
+void analogWrite(uint8_t pin, int value) {
+    digitalWrite(pin, value > 127 ? HIGH : LOW);
+}
+
+void host_analog_set(uint8_t pin, uint16_t value) {
+    if(pin < HAL_PINS) {
+        analog_levels[pin] = value;
+    }
+}
+
+void host_digital_set(uint8_t pin, uint8_t level) {
+    if(pin < HAL_PINS) {
+        pin_levels[pin] = level ? HIGH : LOW;
+    }
+}
+
+// Time is kept by the board
+
+unsigned long millis(void) {
+    return (uint32_t)(board_micros() / 1000);
+}
+
+unsigned long micros(void) {
+    return (uint32_t)board_micros();
+}
+
+void delay(unsigned long ms) {
+    board_delay(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    board_delay(us);
+}
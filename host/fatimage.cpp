@@ -0,0 +1,274 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "fatimage.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// One partitionless FAT16 volume with every file in consecutive clusters.
+// Dates are fixed so that the same directory always makes the same image.
+
+#define FAT_BLOCK           512
+#define FAT_RESERVED        1
+#define FAT_COPIES          2
+#define FAT_ROOT_ENTRIES    512
+#define FAT_MIN_SIZE        (32UL * 1024 * 1024)
+#define FAT_MAX_CLUSTERS    65524
+#define FAT_DATE            ((2014 - 1980) << 9 | 1 << 5 | 1)
+
+struct fat_file {
+    char name[11];
+    char path[512];
+    uint32_t size;
+    uint16_t cluster;
+};
+
+static bool fat_name(const char *name, char *fat) {
+    const char *dot = strrchr(name, '.');
+    size_t base = dot ? (size_t)(dot - name) : strlen(name);
+    size_t extension = dot ? strlen(dot + 1) : 0;
+
+    if(base == 0 || base > 8 || extension > 3) {
+        return false;
+    }
+
+    memset(fat, ' ', 11);
+
+    for(size_t i = 0; i < base; i++) {
+        if(!isalnum((unsigned char)name[i]) && !strchr("_-~", name[i])) {
+            return false;
+        }
+
+        fat[i] = toupper((unsigned char)name[i]);
+    }
+
+    for(size_t i = 0; i < extension; i++) {
+        if(!isalnum((unsigned char)dot[1 + i])) {
+            return false;
+        }
+
+        fat[8 + i] = toupper((unsigned char)dot[1 + i]);
+    }
+
+    return true;
+}
+
+static void put16(uint8_t *p, uint16_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t value) {
+    put16(p, value);
+    put16(p + 2, value >> 16);
+}
+
+static bool put_block(FILE *image, uint32_t block, const uint8_t *data,
+        size_t size) {
+    return fseek(image, (long)block * FAT_BLOCK, SEEK_SET) == 0 &&
+           fwrite(data, 1, size, image) == size;
+}
+
+bool fat_image_build(const char *directory, const char *path) {
+    static fat_file files[FAT_ROOT_ENTRIES];
+    uint16_t count = 0;
+    uint64_t data_bytes = 0;
+
+    // Sorted, so the directory order doesn't depend on the host filesystem
+    struct dirent **entries;
+    int n = scandir(directory, &entries, NULL, alphasort);
+
+    if(n < 0) {
+        perror(directory);
+        return false;
+    }
+
+    for(int i = 0; i < n; i++) {
+        fat_file *file = &files[count];
+        struct stat info;
+
+        snprintf(file->path, sizeof(file->path), "%s/%s", directory,
+                entries[i]->d_name);
+
+        if(stat(file->path, &info) == 0 && S_ISREG(info.st_mode)) {
+            if(count == FAT_ROOT_ENTRIES) {
+                fprintf(stderr, "%s: too many files\n", directory);
+            } else if(!fat_name(entries[i]->d_name, file->name)) {
+                fprintf(stderr, "%s: not an 8.3 name, left out\n",
+                        file->path);
+            } else {
+                file->size = info.st_size;
+                data_bytes += info.st_size + 64 * 1024;
+                count++;
+            }
+        }
+
+        free(entries[i]);
+    }
+
+    free(entries);
+
+    // Smallest cluster that keeps the count in FAT16's range
+    uint64_t size = data_bytes + 1024 * 1024;
+
+    if(size < FAT_MIN_SIZE) {
+        size = FAT_MIN_SIZE;
+    }
+
+    uint8_t cluster_blocks = 4;
+
+    while(size / FAT_BLOCK / cluster_blocks > FAT_MAX_CLUSTERS) {
+        if(cluster_blocks == 64) {
+            fprintf(stderr, "%s: too big for FAT16\n", directory);
+            return false;
+        }
+
+        cluster_blocks *= 2;
+    }
+
+    uint32_t total = size / FAT_BLOCK;
+    uint32_t root_blocks = FAT_ROOT_ENTRIES * 32 / FAT_BLOCK;
+    uint32_t clusters = (total - FAT_RESERVED - root_blocks) / cluster_blocks;
+    uint32_t fat_blocks = (clusters * 2 + FAT_BLOCK - 1) / FAT_BLOCK + 1;
+    uint32_t root = FAT_RESERVED + FAT_COPIES * fat_blocks;
+    uint32_t data = root + root_blocks;
+
+    clusters = (total - data) / cluster_blocks;
+
+    FILE *image = fopen(path, "w+b");
+
+    if(!image) {
+        perror(path);
+        return false;
+    }
+
+    bool ok = ftruncate(fileno(image), (off_t)total * FAT_BLOCK) == 0;
+
+    // Boot sector
+    uint8_t block[FAT_BLOCK] = { 0xEB, 0x3C, 0x90 };
+
+    memcpy(&block[3], "MSDOS5.0", 8);
+    put16(&block[11], FAT_BLOCK);
+    block[13] = cluster_blocks;
+    put16(&block[14], FAT_RESERVED);
+    block[16] = FAT_COPIES;
+    put16(&block[17], FAT_ROOT_ENTRIES);
+    put16(&block[19], total > 0xFFFF ? 0 : total);
+    block[21] = 0xF8;
+    put16(&block[22], fat_blocks);
+    put16(&block[24], 32);
+    put16(&block[26], 64);
+    put32(&block[32], total > 0xFFFF ? total : 0);
+    block[36] = 0x80;
+    block[38] = 0x29;
+    put32(&block[39], 0x41524753);
+    memcpy(&block[43], "ARGENTUM   FAT16   ", 19);
+    block[510] = 0x55;
+    block[511] = 0xAA;
+
+    ok = ok && put_block(image, 0, block, FAT_BLOCK);
+
+    // Files, each in a chain of consecutive clusters
+    static uint16_t fat[FAT_MAX_CLUSTERS + 2];
+    uint32_t next = 2;
+
+    memset(fat, 0, sizeof(fat));
+    fat[0] = 0xFFF8;
+    fat[1] = 0xFFFF;
+
+    for(uint16_t i = 0; i < count && ok; i++) {
+        uint32_t cluster_bytes = cluster_blocks * FAT_BLOCK;
+        uint32_t length = (files[i].size + cluster_bytes - 1) / cluster_bytes;
+
+        if(next + length > clusters + 2) {
+            fprintf(stderr, "%s: card full\n", files[i].path);
+            ok = false;
+            break;
+        }
+
+        files[i].cluster = length ? next : 0;
+
+        for(uint32_t c = 0; c < length; c++, next++) {
+            fat[next] = c + 1 == length ? 0xFFFF : next + 1;
+        }
+
+        FILE *in = fopen(files[i].path, "rb");
+
+        if(!in) {
+            perror(files[i].path);
+            ok = false;
+            break;
+        }
+
+        uint32_t at = data + (files[i].cluster - 2) * cluster_blocks;
+        size_t got;
+
+        while(ok && (got = fread(block, 1, FAT_BLOCK, in)) > 0) {
+            ok = put_block(image, at++, block, got);
+        }
+
+        fclose(in);
+    }
+
+    for(uint8_t copy = 0; copy < FAT_COPIES && ok; copy++) {
+        uint32_t at = FAT_RESERVED + copy * fat_blocks;
+
+        for(uint32_t b = 0; b * 256 < next && ok; b++) {
+            memset(block, 0, sizeof(block));
+
+            for(uint16_t e = 0; e < 256 && b * 256 + e < next; e++) {
+                put16(&block[e * 2], fat[b * 256 + e]);
+            }
+
+            ok = put_block(image, at + b, block, FAT_BLOCK);
+        }
+    }
+
+    // Root directory
+    for(uint16_t i = 0; i < count && ok; i++) {
+        uint8_t entry[32] = { 0 };
+
+        memcpy(entry, files[i].name, 11);
+        entry[11] = 0x20;
+        put16(&entry[16], FAT_DATE);
+        put16(&entry[18], FAT_DATE);
+        put16(&entry[24], FAT_DATE);
+        put16(&entry[26], files[i].cluster);
+        put32(&entry[28], files[i].size);
+
+        ok = fseek(image, (long)root * FAT_BLOCK + i * 32, SEEK_SET) == 0 &&
+             fwrite(entry, 1, sizeof(entry), image) == sizeof(entry);
+    }
+
+    if(fclose(image) != 0 || !ok) {
+        fprintf(stderr, "%s: couldn't write the card image\n", path);
+        return false;
+    }
+
+    return true;
+}
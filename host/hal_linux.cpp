@@ -0,0 +1,191 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hal.h"
+#include "host.h"
+
+#include "../src/argentum/argentum.h"
+
+// Cartridge ports. The board gets to see every change of the primitive
+// lines, together with the address they went to.
+
+static uint8_t cartridge_address = 0;
+static uint8_t cartridge_right = 0;
+static uint8_t cartridge_left = 0;
+
+void hal_cartridge_initialise(void) {
+    cartridge_address = 0;
+    cartridge_right = 0;
+    cartridge_left = 0;
+}
+
+void hal_cartridge_address(uint8_t address) {
+    cartridge_address = address;
+}
+
+void hal_cartridge_primitives(uint8_t right, uint8_t left) {
+    cartridge_right = right;
+    cartridge_left = left;
+
+    board_cartridge(cartridge_address, right, left);
+}
+
+void hal_cartridge_settle(void) {
+}
+
+// Pulse timer, derived from micros(). The alarm has no interrupt to run
+// it, hal_poll() checks whether it is due.
+
+static bool alarm_armed = false;
+static uint32_t alarm_us;
+
+void hal_timer_initialise(void) {
+    alarm_armed = false;
+}
+
+uint16_t hal_timer_ticks(void) {
+    return micros() * HAL_TIMER_TICKS_PER_US;
+}
+
+void hal_timer_alarm(uint16_t at) {
+    uint16_t ticks = at - hal_timer_ticks();
+
+    alarm_us = micros() + ticks / HAL_TIMER_TICKS_PER_US;
+    alarm_armed = true;
+}
+
+void hal_timer_alarm_cancel(void) {
+    alarm_armed = false;
+}
+
+// Cycle counter, micros() scaled to F_CPU. Only as fine as a microsecond.
+
+uint16_t hal_cycles_start(void) {
+    return 0;
+}
+
+uint16_t hal_cycles(void) {
+    return micros() * (F_CPU / 1000000UL);
+}
+
+void hal_cycles_stop(uint16_t /*state*/) {
+}
+
+uint8_t hal_irq_save(void) {
+    return 0;
+}
+
+void hal_irq_restore(uint8_t /*state*/) {
+}
+
+void hal_poll(void) {
+    if(alarm_armed && (int32_t)(micros() - alarm_us) >= 0) {
+        hal_timer_alarm_handler();
+    }
+}
+
+void hal_halt(void) {
+    fflush(stdout);
+    exit(0);
+}
+
+// Limit switches are wired to ordinary pins, whose levels the board sets.
+
+bool hal_limit_x_positive(void) {
+    return digitalRead(PIN_LIMIT_X_POSITIVE);
+}
+
+bool hal_limit_x_negative(void) {
+    return digitalRead(PIN_LIMIT_X_NEGATIVE);
+}
+
+bool hal_limit_y_positive(void) {
+    return digitalRead(PIN_LIMIT_Y_POSITIVE);
+}
+
+bool hal_limit_y_negative(void) {
+    return digitalRead(PIN_LIMIT_Y_NEGATIVE);
+}
+
+// EEPROM
+
+static uint8_t eeprom[HAL_EEPROM_SIZE];
+static bool eeprom_loaded = false;
+
+const char *host_eeprom_file = NULL;
+
+void host_eeprom_load(void) {
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    eeprom_loaded = true;
+
+    if(!host_eeprom_file) {
+        return;
+    }
+
+    FILE *file = fopen(host_eeprom_file, "rb");
+
+    if(file) {
+        if(fread(eeprom, 1, sizeof(eeprom), file) != sizeof(eeprom)) {
+            fprintf(stderr, "%s: short EEPROM image\n", host_eeprom_file);
+        }
+
+        fclose(file);
+    }
+}
+
+void host_eeprom_save(void) {
+    if(!host_eeprom_file) {
+        return;
+    }
+
+    FILE *file = fopen(host_eeprom_file, "wb");
+
+    if(!file) {
+        perror(host_eeprom_file);
+        return;
+    }
+
+    fwrite(eeprom, 1, sizeof(eeprom), file);
+    fclose(file);
+}
+
+uint8_t hal_eeprom_read(uint16_t address) {
+    if(!eeprom_loaded) {
+        host_eeprom_load();
+    }
+
+    return address < HAL_EEPROM_SIZE ? eeprom[address] : 0xFF;
+}
+
+void hal_eeprom_write(uint16_t address, uint8_t value) {
+    if(!eeprom_loaded) {
+        host_eeprom_load();
+    }
+
+    if(address < HAL_EEPROM_SIZE) {
+        eeprom[address] = value;
+    }
+}
@@ -0,0 +1,77 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _HOST_H_
+#define _HOST_H_
+
+#include <stdint.h>
+
+// State of the native build that has no counterpart on the printer.
+
+// SD card image, NULL for no card.
+extern const char *host_sd_image;
+
+// EEPROM contents are loaded from and saved back to this file if set,
+// otherwise they start erased and are lost on exit.
+extern const char *host_eeprom_file;
+
+void host_eeprom_load(void);
+void host_eeprom_save(void);
+
+// True once stdin has closed and everything read from it has been used.
+bool host_serial_finished(void);
+
+// Read before stdin, as if it had been typed first.
+void host_serial_inject(const char *text);
+
+// Input pin levels and analog readings, as the firmware will see them
+void host_digital_set(uint8_t pin, uint8_t level);
+void host_analog_set(uint8_t pin, uint16_t value);
+
+// What the firmware is attached to. host/main.cpp is a bare board with
+// nothing connected that runs in real time, host/sim.cpp is a simulated
+// printer with a virtual clock.
+
+// Microseconds since reset, and time passing in delay()
+uint64_t board_micros(void);
+void board_delay(uint32_t us);
+
+// Called after every digitalWrite()
+void board_pin_written(uint8_t pin, uint8_t level);
+
+// Every write to the primitive ports, with the address port as it is then
+void board_cartridge(uint8_t address, uint8_t right, uint8_t left);
+
+// A block read from or written to the card at an SPI clock of
+// F_CPU / divisor
+void board_sd_block(uint8_t divisor);
+
+// Serial line timing: how many of the pending input bytes have arrived,
+// and the firmware taking one of them or sending one.
+uint32_t board_serial_arrived(uint32_t pending);
+void board_serial_received(void);
+void board_serial_sent(void);
+
+// Blocking input stalls the board until the host sends more, rather than
+// letting time run on without it.
+extern bool host_serial_blocking;
+
+#endif
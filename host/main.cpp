@@ -0,0 +1,134 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "host.h"
+
+#include "../src/argentum/argentum.h"
+
+// From the sketch
+void setup(void);
+void loop(void);
+void serialEvent(void);
+
+// A bare board: nothing on the cartridge, motor or SD card pins, no
+// switch pressed, and time passes as it does on the host.
+
+uint64_t board_micros(void) {
+    static uint64_t epoch = 0;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    uint64_t us = (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+
+    // Counted from the first call, like it is from reset on the printer
+    if(epoch == 0) {
+        epoch = us;
+    }
+
+    return us - epoch;
+}
+
+void board_delay(uint32_t us) {
+    if(us >= 1000) {
+        fflush(stdout);
+        usleep(us);
+    } else {
+        uint64_t end = board_micros() + us;
+
+        while(board_micros() < end);
+    }
+}
+
+void board_pin_written(uint8_t /*pin*/, uint8_t /*level*/) {
+}
+
+void board_cartridge(uint8_t /*address*/, uint8_t /*right*/, uint8_t /*left*/) {
+}
+
+void board_sd_block(uint8_t /*divisor*/) {
+}
+
+uint32_t board_serial_arrived(uint32_t pending) {
+    return pending;
+}
+
+void board_serial_received(void) {
+}
+
+void board_serial_sent(void) {
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-s sd.img] [-e eeprom.bin]\n", name);
+    fprintf(stderr, "Runs the firmware with serial on stdin and stdout.\n");
+}
+
+int main(int argc, char **argv) {
+    int option;
+
+    while((option = getopt(argc, argv, "s:e:h")) != -1) {
+        switch(option) {
+            case 's':
+                host_sd_image = optarg;
+                break;
+            case 'e':
+                host_eeprom_file = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return option == 'h' ? 0 : 1;
+        }
+    }
+
+    host_eeprom_load();
+
+    // Normally closed switches, none of them pressed
+    host_digital_set(PIN_LIMIT_X_POSITIVE, HIGH);
+    host_digital_set(PIN_LIMIT_X_NEGATIVE, HIGH);
+    host_digital_set(PIN_LIMIT_Y_POSITIVE, HIGH);
+    host_digital_set(PIN_LIMIT_Y_NEGATIVE, HIGH);
+
+    // 12 V on the primitive supply, through the 1/3 divider
+    host_analog_set(PIN_PRIMITIVE_VOLTAGE, 12.0 / 3.0 / 5.0 * 1024);
+
+    setup();
+
+    // What the Arduino core's main() does, until stdin runs out
+    while(!host_serial_finished()) {
+        loop();
+
+        if(Serial.available()) {
+            serialEvent();
+        }
+    }
+
+    Serial.flush();
+    host_eeprom_save();
+
+    return 0;
+}
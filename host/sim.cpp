@@ -0,0 +1,369 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "fatimage.h"
+#include "host.h"
+
+#include "../src/argentum/argentum.h"
+
+// A simulated printer for replaying jobs on the host. Time is virtual: it
+// only moves when the firmware reads the clock, waits, sends or receives
+// on the serial line or uses the card, so a run takes as long as the
+// computer needs and gives the same trace every time.
+
+// From the sketch
+void setup(void);
+void loop(void);
+void serialEvent(void);
+
+// Virtual clock, and what the firmware spends per look at it
+static uint64_t now = 0;
+static uint32_t clock_cost = 2;
+
+uint64_t board_micros(void) {
+    now += clock_cost;
+    return now;
+}
+
+void board_delay(uint32_t us) {
+    now += us;
+}
+
+// Trace of every step and firing, one event a line:
+//   <us> X <position>
+//   <us> Y <position>
+//   <us> F <address> <right> <left> <x> <y>
+static FILE *trace = NULL;
+
+// The carriage, in steps from the negative limit. Motor B drives X, a step
+// with its direction pin low moves to +X. Motor A drives Y the other way
+// round. Past a switch the carriage runs into the frame and steps are lost.
+#define LIMIT_OVERTRAVEL 200
+
+struct axis_model {
+    char name;
+    uint8_t step_pin;
+    uint8_t dir_pin;
+    uint8_t enable_pin;
+    uint8_t positive_dir;
+    uint8_t positive_limit;
+    uint8_t negative_limit;
+    int32_t travel;
+    int32_t position;
+    uint32_t steps;
+    uint32_t stalled;
+};
+
+static axis_model carriage_x = {
+    'X', STEPPER_B_STEP_PIN, STEPPER_B_DIR_PIN, STEPPER_B_ENABLE_PIN, LOW,
+    PIN_LIMIT_X_POSITIVE, PIN_LIMIT_X_NEGATIVE, 14000, 1000, 0, 0
+};
+
+static axis_model carriage_y = {
+    'Y', STEPPER_A_STEP_PIN, STEPPER_A_DIR_PIN, STEPPER_A_ENABLE_PIN, HIGH,
+    PIN_LIMIT_Y_POSITIVE, PIN_LIMIT_Y_NEGATIVE, 14000, 1000, 0, 0
+};
+
+static void axis_limits(axis_model *axis) {
+    // Normally closed, so a pressed switch reads low
+    host_digital_set(axis->positive_limit, axis->position < axis->travel);
+    host_digital_set(axis->negative_limit, axis->position > 0);
+}
+
+static void axis_step(axis_model *axis) {
+    if(digitalRead(axis->enable_pin) != LOW) {
+        return;
+    }
+
+    int32_t to = axis->position;
+
+    to += digitalRead(axis->dir_pin) == axis->positive_dir ? 1 : -1;
+
+    if(to < -LIMIT_OVERTRAVEL || to > axis->travel + LIMIT_OVERTRAVEL) {
+        axis->stalled++;
+        return;
+    }
+
+    axis->position = to;
+    axis->steps++;
+
+    axis_limits(axis);
+
+    if(trace) {
+        fprintf(trace, "%llu %c %ld\n", (unsigned long long)now, axis->name,
+                (long)axis->position);
+    }
+}
+
+void board_pin_written(uint8_t pin, uint8_t level) {
+    if(level != HIGH) {
+        return;
+    }
+
+    if(pin == carriage_x.step_pin) {
+        axis_step(&carriage_x);
+    } else if(pin == carriage_y.step_pin) {
+        axis_step(&carriage_y);
+    }
+}
+
+// Firings
+static uint32_t firings = 0;
+static uint64_t first_firing = 0;
+static uint64_t last_firing = 0;
+
+void board_cartridge(uint8_t address, uint8_t right, uint8_t left) {
+    if(!right && !left) {
+        return;
+    }
+
+    if(firings++ == 0) {
+        first_firing = now;
+    }
+
+    last_firing = now;
+
+    if(trace) {
+        fprintf(trace, "%llu F %02X %02X %02X %ld %ld\n",
+                (unsigned long long)now, address, right, left,
+                (long)carriage_x.position, (long)carriage_y.position);
+    }
+}
+
+// A block over SPI, with the card's command and CRC overhead
+void board_sd_block(uint8_t divisor) {
+    now += (512 + 16) * 8 * (uint32_t)divisor / 16;
+}
+
+// Serial line at 8N1. The host sends as fast as the line goes but never
+// more than the 64 byte receive buffer ahead of the firmware, and sending
+// waits once the 64 byte transmit buffer is full.
+#define SERIAL_BUFFER 64
+
+static uint32_t byte_time = 87;
+static uint64_t rx_arrival = 87;
+static uint64_t tx_done = 0;
+
+uint32_t board_serial_arrived(uint32_t pending) {
+    now += clock_cost;
+
+    if(!pending || now < rx_arrival) {
+        return 0;
+    }
+
+    uint64_t arrived = 1 + (now - rx_arrival) / byte_time;
+
+    if(arrived > SERIAL_BUFFER) {
+        arrived = SERIAL_BUFFER;
+    }
+
+    return arrived < pending ? arrived : pending;
+}
+
+void board_serial_received(void) {
+    rx_arrival += byte_time;
+
+    // Space for one more, which only now starts across the line
+    if(rx_arrival + (SERIAL_BUFFER - 1) * byte_time < now + byte_time) {
+        rx_arrival = now + byte_time - (SERIAL_BUFFER - 1) * byte_time;
+    }
+}
+
+void board_serial_sent(void) {
+    tx_done = (tx_done > now ? tx_done : now) + byte_time;
+
+    if(tx_done > now + SERIAL_BUFFER * byte_time) {
+        now = tx_done - SERIAL_BUFFER * byte_time;
+    }
+}
+
+static char card_image[] = "/tmp/argentum-sim-XXXXXX";
+static bool card_temporary = false;
+
+static void usage(const char *name) {
+    fprintf(stderr,
+        "usage: %s [-s sd.img | -d directory] [-e eeprom.bin] [-p job]\n"
+        "          [-t trace] [-v volts] [-c us] [-b baud] [-w x,y] [-o x,y]\n"
+        "Runs the firmware on a simulated printer in virtual time, serial\n"
+        "on stdin and stdout.\n"
+        "  -s  card image          -d  card made from a directory's files\n"
+        "  -p  print job first     -t  write steps and firings to trace\n"
+        "  -v  primitive supply    -c  time each read of the clock takes\n"
+        "  -b  serial baud rate    -w  travel in steps\n"
+        "  -o  starting position, in steps from the negative limits\n",
+        name);
+}
+
+int main(int argc, char **argv) {
+    const char *directory = NULL;
+    const char *job = NULL;
+    const char *trace_file = NULL;
+    double volts = 12.0;
+    uint32_t baud = 115200;
+    long x_travel, y_travel, x_start, y_start;
+    int option;
+
+    while((option = getopt(argc, argv, "s:d:e:p:t:v:c:b:w:o:h")) != -1) {
+        switch(option) {
+            case 's':
+                host_sd_image = optarg;
+                break;
+            case 'd':
+                directory = optarg;
+                break;
+            case 'e':
+                host_eeprom_file = optarg;
+                break;
+            case 'p':
+                job = optarg;
+                break;
+            case 't':
+                trace_file = optarg;
+                break;
+            case 'v':
+                volts = atof(optarg);
+                break;
+            case 'c':
+                clock_cost = atoi(optarg);
+                break;
+            case 'b':
+                baud = atoi(optarg);
+                break;
+            case 'w':
+                if(sscanf(optarg, "%ld,%ld", &x_travel, &y_travel) != 2) {
+                    usage(argv[0]);
+                    return 1;
+                }
+
+                carriage_x.travel = x_travel;
+                carriage_y.travel = y_travel;
+                break;
+            case 'o':
+                if(sscanf(optarg, "%ld,%ld", &x_start, &y_start) != 2) {
+                    usage(argv[0]);
+                    return 1;
+                }
+
+                carriage_x.position = x_start;
+                carriage_y.position = y_start;
+                break;
+            default:
+                usage(argv[0]);
+                return option == 'h' ? 0 : 1;
+        }
+    }
+
+    if(directory) {
+        int fd = mkstemp(card_image);
+
+        if(fd < 0) {
+            perror(card_image);
+            return 1;
+        }
+
+        close(fd);
+        card_temporary = true;
+
+        if(!fat_image_build(directory, card_image)) {
+            unlink(card_image);
+            return 1;
+        }
+
+        host_sd_image = card_image;
+    }
+
+    if(trace_file) {
+        trace = fopen(trace_file, "w");
+
+        if(!trace) {
+            perror(trace_file);
+            return 1;
+        }
+    }
+
+    if(baud) {
+        byte_time = (10000000 + baud / 2) / baud;
+        rx_arrival = byte_time;
+    }
+
+    if(job) {
+        char command[64];
+
+        snprintf(command, sizeof(command), "p %s\n", job);
+        host_serial_inject(command);
+    }
+
+    // Everything on stdin is there to be sent, wait for it rather than let
+    // the firmware run on without it.
+    host_serial_blocking = true;
+
+    host_eeprom_load();
+    axis_limits(&carriage_x);
+    axis_limits(&carriage_y);
+
+    // Through the 1/3 divider to the 5 V reference
+    host_analog_set(PIN_PRIMITIVE_VOLTAGE, volts / 3.0 / 5.0 * 1024);
+
+    setup();
+
+    while(!host_serial_finished()) {
+        loop();
+
+        if(Serial.available()) {
+            serialEvent();
+        }
+    }
+
+    Serial.flush();
+    host_eeprom_save();
+
+    if(card_temporary) {
+        unlink(card_image);
+    }
+
+    if(trace) {
+        fprintf(trace, "# end %llu\n", (unsigned long long)now);
+        fclose(trace);
+    }
+
+    fprintf(stderr, "time %.6f s\n", now / 1e6);
+    fprintf(stderr, "steps X %lu Y %lu, lost X %lu Y %lu\n",
+            (unsigned long)carriage_x.steps, (unsigned long)carriage_y.steps,
+            (unsigned long)carriage_x.stalled, (unsigned long)carriage_y.stalled);
+    fprintf(stderr, "position X %ld Y %ld\n", (long)carriage_x.position,
+            (long)carriage_y.position);
+    fprintf(stderr, "firings %lu", (unsigned long)firings);
+
+    if(firings) {
+        fprintf(stderr, ", %.6f s to %.6f s", first_firing / 1e6,
+                last_firing / 1e6);
+    }
+
+    fprintf(stderr, "\n");
+
+    return 0;
+}
@@ -29,6 +29,7 @@
 #include "../util/logging.h"
 #include "../util/colour.h"
 #include "../util/SdFat/SdFat.h"
+#include "../util/sdcard.h"
 
 uint8_t current_stage = 0;
 
@@ -49,7 +50,7 @@ bool _check_advance(void) {
                 current_stage = STAGE_0;
             }
 
-            logger.info() << "Advancing to stage " << current_stage
+            logger.info() << F("Advancing to stage ") << current_stage
                 << Comms::endl;
 
             return true;
@@ -60,7 +61,7 @@ bool _check_advance(void) {
 }
 
 void stage_0(void) {
-    logger.info("Stage 0 - Check Hardware.");
+    logger.info(F("Stage 0 - Check Hardware."));
 
     while(current_stage == STAGE_0) {
         check_advance();
@@ -68,12 +69,15 @@ void stage_0(void) {
 }
 
 void stage_1(void) {
-    logger.info("Stage 1 - Read SD card, report over serial.");
+    logger.info(F("Stage 1 - Read SD card, report over serial."));
 
-    if(!sd.begin(53, SPI_HALF_SPEED)) {
-        logger.error("Failed to initialise SD card.");
+    if(!sdcard_probe(&sd, 53)) {
+        logger.error(F("Failed to initialise SD card."));
     } else {
-        logger.info("Files on SD card:");
+        logger.info() << F("SD card SPI clock ")
+            << (F_CPU / sdcard_divisor() / 1000) << F(" kHz") << Comms::endl;
+
+        logger.info(F("Files on SD card:"));
 
         SdFile file;
         char name[13];
@@ -95,7 +99,7 @@ void stage_1(void) {
 }
 
 void stage_2(void) {
-    logger.info("Stage 2 - Feedback Vadj voltage over serial.");
+    logger.info(F("Stage 2 - Feedback Vadj voltage over serial."));
 
     analog_initialise();
 
@@ -105,8 +109,8 @@ void stage_2(void) {
         uint16_t reading = analog_read(PIN_PRIMITIVE_VOLTAGE);
         double voltage = primitive_voltage();
 
-        logger.info() << "Voltage = " << voltage << " V" << " (" << reading
-            << ")"<< Comms::endl;
+        logger.info() << F("Voltage = ") << voltage << F(" V") << F(" (") << reading
+            << F(")")<< Comms::endl;
 
         delay(100);
     }
@@ -131,33 +135,33 @@ void fet_ramp(uint8_t pin) {
 }
 
 void stage_3(void) {
-    logger.info("Stage 3 - Blink LED strips in series.");
+    logger.info(F("Stage 3 - Blink LED strips in series."));
 
     fet_initialise();
 
     while(current_stage == STAGE_3) {
-        logger.info("Ramping Fet 1");
+        logger.info(F("Ramping Fet 1"));
         fet_ramp(PIN_FET_1);
 
         if(current_stage != STAGE_3) {
             break;
         }
 
-        logger.info("Ramping Fet 2");
+        logger.info(F("Ramping Fet 2"));
         fet_ramp(PIN_FET_2);
 
         if(current_stage != STAGE_3) {
             break;
         }
 
-        logger.info("Ramping Fet 3");
+        logger.info(F("Ramping Fet 3"));
         fet_ramp(PIN_FET_3);
 
         if(current_stage != STAGE_3) {
             break;
         }
 
-        logger.info("All off - 2 seconds");
+        logger.info(F("All off - 2 seconds"));
         fet_set_value(PIN_FET_1, 0);
         fet_set_value(PIN_FET_2, 0);
         fet_set_value(PIN_FET_3, 0);
@@ -170,33 +174,33 @@ void stage_3(void) {
 }
 
 void stage_4(void) {
-    logger.info("Stage 4 - Blink RGB channels in series");
+    logger.info(F("Stage 4 - Blink RGB channels in series"));
 
     colour_init();
 
     while(current_stage == STAGE_4) {
-        logger.info("Ramping Red");
+        logger.info(F("Ramping Red"));
         fet_ramp(PIN_FET_RED);
 
         if(current_stage != STAGE_4) {
             break;
         }
 
-        logger.info("Ramping Green");
+        logger.info(F("Ramping Green"));
         fet_ramp(PIN_FET_GREEN);
 
         if(current_stage != STAGE_4) {
             break;
         }
 
-        logger.info("Ramping Blue");
+        logger.info(F("Ramping Blue"));
         fet_ramp(PIN_FET_BLUE);
 
         if(current_stage != STAGE_4) {
             break;
         }
 
-        logger.info("All off - 2 seconds");
+        logger.info(F("All off - 2 seconds"));
         fet_set_value(PIN_FET_RED, 0);
         fet_set_value(PIN_FET_GREEN, 0);
         fet_set_value(PIN_FET_BLUE, 0);
@@ -221,37 +225,37 @@ void stage_5(void) {
     #define SERVO_MAX 180
 
     while(current_stage == STAGE_5) {
-        logger.info("Servo 1 Min");
+        logger.info(F("Servo 1 Min"));
         a.write(SERVO_MIN);
         delay(500);
 
         check_advance();
 
-        logger.info("Servo 1 Max");
+        logger.info(F("Servo 1 Max"));
         a.write(SERVO_MAX);
         delay(500);
 
         check_advance();
 
-        logger.info("Servo 2 Min");
+        logger.info(F("Servo 2 Min"));
         b.write(SERVO_MIN);
         delay(500);
 
         check_advance();
 
-        logger.info("Servo 2 Max");
+        logger.info(F("Servo 2 Max"));
         b.write(SERVO_MAX);
         delay(500);
 
         check_advance();
 
-        logger.info("Servo 3 Min");
+        logger.info(F("Servo 3 Min"));
         c.write(SERVO_MIN);
         delay(500);
 
         check_advance();
 
-        logger.info("Servo 3 Max");
+        logger.info(F("Servo 3 Max"));
         c.write(SERVO_MAX);
         delay(500);
 
@@ -264,7 +268,7 @@ void stage_5(void) {
 }
 
 void stage_6(void) {
-    logger.info("Stage 6 - Feedback endstop states over serial.");
+    logger.info(F("Stage 6 - Feedback endstop states over serial."));
 
     uint8_t switches = limit_switches();
     print_switch_status(switches);
@@ -280,7 +284,7 @@ void stage_6(void) {
 }
 
 void stage_7(void) {
-    logger.info("Stage 7 - Nozzle test print. (Use nozzle test hex file)");
+    logger.info(F("Stage 7 - Nozzle test print. (Use nozzle test hex file)"));
 
     while(current_stage == STAGE_7) {
         check_advance();
@@ -127,7 +127,7 @@ bool freedom(bool *x_direction_resolved, bool *y_direction_resolved) {
             Axis *axis;
 
             if(axis_correct) {
-                logger.info("Found A = X");
+                logger.info(F("Found A = X"));
 
                 axis = &x_axis;
 
@@ -136,7 +136,7 @@ bool freedom(bool *x_direction_resolved, bool *y_direction_resolved) {
 
                 *x_direction_resolved = true;
             } else {
-                logger.info("Found A = Y");
+                logger.info(F("Found A = Y"));
 
                 axis = &y_axis;
 
@@ -147,11 +147,11 @@ bool freedom(bool *x_direction_resolved, bool *y_direction_resolved) {
             }
 
             if(direction_correct) {
-                logger.info("Found + = +");
+                logger.info(F("Found + = +"));
 
                 axis->set_motor_mapping(Axis::CW_Positive);
             } else {
-                logger.info("Found + = -");
+                logger.info(F("Found + = -"));
 
                 //a_motor.set_direction(Stepper::CCW);
                 axis->set_motor_mapping(Axis::CW_Negative);
@@ -169,7 +169,7 @@ bool freedom(bool *x_direction_resolved, bool *y_direction_resolved) {
             Axis *axis;
 
             if(axis_correct) {
-                logger.info("Found B = Y");
+                logger.info(F("Found B = Y"));
 
                 axis = &y_axis;
 
@@ -178,7 +178,7 @@ bool freedom(bool *x_direction_resolved, bool *y_direction_resolved) {
 
                 *y_direction_resolved = true;
             } else {
-                logger.info("Found B = X");
+                logger.info(F("Found B = X"));
 
                 axis = &x_axis;
 
@@ -189,18 +189,18 @@ bool freedom(bool *x_direction_resolved, bool *y_direction_resolved) {
             }
 
             if(direction_correct) {
-                logger.info("Found + = +");
+                logger.info(F("Found + = +"));
 
                 axis->set_motor_mapping(Axis::CW_Positive);
             } else {
-                logger.info("Found + = -");
+                logger.info(F("Found + = -"));
 
                 //b_motor.set_direction(Stepper::CCW);
                 axis->set_motor_mapping(Axis::CW_Negative);
             }
         }
     } else {
-        logger.info("No switches are initially triggered.");
+        logger.info(F("No switches are initially triggered."));
     }
 
     return (a_resolved | b_resolved);
@@ -208,7 +208,7 @@ bool freedom(bool *x_direction_resolved, bool *y_direction_resolved) {
 
 bool retry_calibrate(CalibrationData *calibration)
 {
-    logger.info("Calibration beginning.");
+    logger.info(F("Calibration beginning."));
 
     x_axis.debug_info();
     y_axis.debug_info();
@@ -238,7 +238,7 @@ bool retry_calibrate(CalibrationData *calibration)
         return false;
 
     if(!axes_resolved) {
-        logger.info("Resolved nothing, finding X");
+        logger.info(F("Resolved nothing, finding X"));
 
         while(!limit_any()) {
             while(!x_axis.get_motor()->step())
@@ -247,7 +247,7 @@ bool retry_calibrate(CalibrationData *calibration)
         }
 
         if(limit_y()) {
-            logger.info("Found axes swapped.");
+            logger.info(F("Found axes swapped."));
             // Incorrect mapping
             Stepper *temp = x_axis.get_motor();
 
@@ -258,7 +258,7 @@ bool retry_calibrate(CalibrationData *calibration)
 
     while(!(x_direction_resolved && y_direction_resolved)) {
         if(!x_direction_resolved) {
-            //logger.info("Stepping X");
+            logger.debug(F("Stepping X"));
 
             if(!limit_x()) {
                 x_axis.get_motor()->step();
@@ -267,14 +267,14 @@ bool retry_calibrate(CalibrationData *calibration)
 
                 if(limit_x_negative()) {
                     // Inverted
-                    logger.info("Found X to be inverted.");
+                    logger.info(F("Found X to be inverted."));
                     x_axis.set_motor_mapping(Axis::CW_Negative);
                 }
             }
         }
 
         if(!y_direction_resolved) {
-            //logger.info("Stepping Y");
+            logger.debug(F("Stepping Y"));
 
             if(!limit_y()) {
                 y_axis.get_motor()->step();
@@ -283,7 +283,7 @@ bool retry_calibrate(CalibrationData *calibration)
 
                 if(limit_y_negative()) {
                     // Inverted
-                    logger.info("Found Y to be inverted.");
+                    logger.info(F("Found Y to be inverted."));
                     y_axis.set_motor_mapping(Axis::CW_Negative);
                 }
             }
@@ -297,22 +297,22 @@ bool retry_calibrate(CalibrationData *calibration)
     x_axis.debug_info();
     y_axis.debug_info();
 
-    logger.info("Homing");
+    logger.info(F("Homing"));
 
     x_axis.move_to_negative();
     if (limit_x_negative())
-        logger.info("x-");
+        logger.info(F("x-"));
     else
     {
-        logger.info("x- failed! Restarting.");
+        logger.info(F("x- failed! Restarting."));
         return false;
     }
     y_axis.move_to_negative();
     if (limit_y_negative())
-        logger.info("y-");
+        logger.info(F("y-"));
     else
     {
-        logger.info("y- failed! Restarting calibration.");
+        logger.info(F("y- failed! Restarting calibration."));
         return false;
     }
 
@@ -325,18 +325,18 @@ bool retry_calibrate(CalibrationData *calibration)
     // Go to maximum extents
     x_axis.move_to_positive();
     if (limit_x_positive())
-        logger.info("x+");
+        logger.info(F("x+"));
     else
     {
-        logger.info("x+ failed! Restarting.");
+        logger.info(F("x+ failed! Restarting."));
         return false;
     }
     y_axis.move_to_positive();
     if (limit_y_positive())
-        logger.info("y+");
+        logger.info(F("y+"));
     else
     {
-        logger.info("y+ failed! Restarting calibration.");
+        logger.info(F("y+ failed! Restarting calibration."));
         return false;
     }
 
@@ -349,18 +349,18 @@ bool retry_calibrate(CalibrationData *calibration)
     // Return to home
     x_axis.move_to_negative();
     if (limit_x_negative())
-        logger.info("x-");
+        logger.info(F("x-"));
     else
     {
-        logger.info("x- failed! Restarting.");
+        logger.info(F("x- failed! Restarting."));
         return false;
     }
     y_axis.move_to_negative();
     if (limit_y_negative())
-        logger.info("y-");
+        logger.info(F("y-"));
     else
     {
-        logger.info("y- failed! Restarting calibration.");
+        logger.info(F("y- failed! Restarting calibration."));
         return false;
     }
 
@@ -393,7 +393,7 @@ bool calibrate(CalibrationData *calibration)
             return true;
         if (no_power())
         {
-            logger.info("No power. Stopping calibration.");
+            logger.info(F("No power. Stopping calibration."));
             break;
         }
     }
@@ -30,6 +30,16 @@
 #include "../util/colour.h"
 #include "../util/rollers.h"
 #include "../util/cartridge.h"
+#include "../util/firing.h"
+#include "../util/nozzles.h"
+#include "../util/blockio.h"
+#include "../util/sdcard.h"
+#include "../util/catalogue.h"
+#include "../util/arena.h"
+#include "../util/hal.h"
+#include "../util/profile.h"
+#include "../util/telemetry.h"
+#include "../util/trace.h"
 //#include <SD.h>
 
 #include "../util/comms.h"
@@ -40,6 +50,8 @@
 extern "C" {
 #include "../util/md5.h"
 #include "../util/decb.h"
+#include "../util/hexdecode.h"
+#include "../util/crc32.h"
 }
 
 #include "boardtests.h"
@@ -47,27 +59,29 @@ extern "C" {
 #include "argentum.h"
 
 static char sd_initialized = 0;
+static bool sd_begin(bool probe);
 
 extern bool readFile(char *filename);
 extern void file_stats(char *filename);
+extern BlockReader reader;
 void moveTo(long x, long y);
 
 void motors_off_command(void) {
-    Serial.println("Motors off");
+    Serial.println(F("Motors off"));
 
     x_axis.get_motor()->enable(false);
     y_axis.get_motor()->enable(false);
 }
 
 void motors_on_command(void) {
-    Serial.println("Motors on");
+    Serial.println(F("Motors on"));
 
     x_axis.get_motor()->enable(true);
     y_axis.get_motor()->enable(true);
 }
 
 void read_setting_command(void) {
-    Serial.println("Current Global Settings:");
+    Serial.println(F("Current Global Settings:"));
     settings_print_settings(&global_settings);
 }
 
@@ -76,7 +90,7 @@ void read_saved_setting_command(void) {
 
     settings_read_settings(&settings);
 
-    Serial.println("EEPROM Settings:");
+    Serial.println(F("EEPROM Settings:"));
     settings_print_settings(&settings);
 }
 
@@ -107,7 +121,7 @@ void speed_command(void) {
     arg = serial_command.next();
 
     if(arg == NULL) {
-        Serial.println("Missing axis parameter");
+        Serial.println(F("Missing axis parameter"));
         return;
     }
 
@@ -116,7 +130,7 @@ void speed_command(void) {
     arg = serial_command.next();
 
     if(arg == NULL) {
-        Serial.println("Missing speed parameter");
+        Serial.println(F("Missing speed parameter"));
         return;
     }
 
@@ -136,7 +150,7 @@ void acceleration_command(void) {
     arg = serial_command.next();
 
     if(arg == NULL) {
-        Serial.println("Missing axis parameter");
+        Serial.println(F("Missing axis parameter"));
         return;
     }
 
@@ -145,7 +159,7 @@ void acceleration_command(void) {
     arg = serial_command.next();
 
     if(arg == NULL) {
-        Serial.println("Missing acceleration parameter");
+        Serial.println(F("Missing acceleration parameter"));
         return;
     }
 
@@ -158,7 +172,7 @@ void acceleration_command(void) {
 }
 
 void zero_position_command(void) {
-    logger.info("Setting new zero position");
+    logger.info(F("Setting new zero position"));
     //xMotor->set_position(0L);
     //yMotor->set_position(0L);
 
@@ -167,7 +181,7 @@ void zero_position_command(void) {
 }
 
 void goto_zero_command(void) {
-    logger.info("Returning to 0.000, 0.000");
+    logger.info(F("Returning to 0.000, 0.000"));
 
     x_axis.move_absolute(0.000);
     y_axis.move_absolute(0.000);
@@ -178,15 +192,15 @@ void home_command(void) {
     y_axis.move_to_negative();
     x_axis.zero();
     y_axis.zero();
-    logger.info("Homed");
+    logger.info(F("Homed"));
 }
 
 void current_position_command(void) {
-    logger.info() << "X: " << x_axis.get_current_position_mm() << " mm, "
-            << "Y: " << y_axis.get_current_position_mm() << " mm"
+    logger.info() << F("X: ") << x_axis.get_current_position_mm() << F(" mm, ")
+            << F("Y: ") << y_axis.get_current_position_mm() << F(" mm")
             << Comms::endl;
-    logger.info() << "X: " << x_axis.get_current_position() << " steps, "
-            << "Y: " << y_axis.get_current_position() << " steps"
+    logger.info() << F("X: ") << x_axis.get_current_position() << F(" steps, ")
+            << F("Y: ") << y_axis.get_current_position() << F(" steps")
             << Comms::endl;
 }
 
@@ -196,7 +210,7 @@ void move_command(void) {
     arg = serial_command.next();
 
     if(arg == NULL) {
-        logger.error("Missing axis parameter");
+        logger.error(F("Missing axis parameter"));
         return;
     }
 
@@ -210,14 +224,14 @@ void move_command(void) {
         moveTo(x, y);
         arg = serial_command.next();
         if (arg && arg[0] == 'k')
-            logger.info() << "Ok" << Comms::endl;
+            logger.info() << F("Ok") << Comms::endl;
         return;
     }
 
     arg = serial_command.next();
 
     if(arg == NULL) {
-        logger.error("Missing steps parameter");
+        logger.error(F("Missing steps parameter"));
         return;
     }
 
@@ -256,7 +270,7 @@ Stepper * motor_from_axis(unsigned const char axis) {
 }
 
 void continuous_move(void) {
-    logger.warn("Not implemented.");
+    logger.warn(F("Not implemented."));
 }
 
 void move(const char axis_id, long steps) {
@@ -264,12 +278,13 @@ void move(const char axis_id, long steps) {
     Axis *axis = axis_from_id(axis_id);
 
     if(!axis) {
-        logger.error() << "Cannot obtain pointer for " << axis_id << " axis"
+        logger.error() << F("Cannot obtain pointer for ") << axis_id << F(" axis")
                 << Comms::endl;
         return;
     }
 
-    //logger.info() << "Moving " << axis << " axis " << steps << "steps" << Comms::endl;
+    logger.debug() << F("Moving ") << axis_id << F(" axis ") << steps << F(" steps")
+            << Comms::endl;
 
     if(steps == 0) {
         //motor->reset_position();
@@ -277,7 +292,7 @@ void move(const char axis_id, long steps) {
 
         axis->move_incremental(-(int32_t)axis->get_current_position());
     } else {
-        axis->move_incremental(steps);
+        axis->move_incremental((int32_t)steps);
     }
 
     axis->wait_for_move();
@@ -302,7 +317,7 @@ void power_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("Missing axis parameter");
+        logger.error(F("Missing axis parameter"));
         return;
     }
 
@@ -311,7 +326,7 @@ void power_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("Missing power parameter");
+        logger.error(F("Missing power parameter"));
         return;
     }
 
@@ -327,7 +342,7 @@ void power_command(void) {
         //motor = yMotor;
         motor = y_axis.get_motor();
     } else {
-        logger.error("No axis");
+        logger.error(F("No axis"));
         return;
     }
 
@@ -338,13 +353,13 @@ void power_command(void) {
         //motor->power(1);
         motor->enable(true);
     } else {
-        logger.error("Unknown power");
+        logger.error(F("Unknown power"));
         return;
     }
 }
 
 void lower_command(void) {
-    logger.info("Lower/Raise");
+    logger.info(F("Lower/Raise"));
 
     rollers.deploy();
 
@@ -352,35 +367,141 @@ void lower_command(void) {
 }
 
 void pause_command(void) {
-    Serial.println("Paused - enter R to resume");
+    Serial.println(F("Paused - enter R to resume"));
     while(Serial.read() != 'R');
 
-    Serial.println("Resuming");
+    Serial.println(F("Resuming"));
 }
 
 void resume_command(void) {
-    Serial.println("Resuming");
-}
-
-char hexdig(char ch)
-{
-    if (ch >= '0' && ch <= '9')
-        return ch - '0';
-    if (ch >= 'A' && ch <= 'F')
-        return ch - 'A' + 10;
-    if (ch >= 'a' && ch <= 'f')
-        return ch - 'a' + 10;
-    return 0;
+    Serial.println(F("Resuming"));
 }
 
 void fire_spec(char *spec)
 {
     byte a, f1, f2;
 
-    a = hexdig(spec[0]);
-    f1 = (hexdig(spec[1]) << 4) | hexdig(spec[2]);
-    f2 = (hexdig(spec[3]) << 4) | hexdig(spec[4]);
+    hex_decode_spec(spec, &a, &f1, &f2);
     fire_head(f1, a, f2, a);
+    nozzles_flush_if_needed();
+}
+
+// Fire-on-the-fly. Print playback queues firings against the Y position the
+// head will be at once every move read so far is done, and the Y axis fires
+// them as it steps past. Moves along Y only extend the current move, so the
+// carriage keeps going at constant speed between columns.
+bool fly_enabled = FLY;
+
+void fly_command(void) {
+#if !FLY
+    logger.info(F("Built without FLY"));
+    return;
+#endif
+
+    fly_enabled = !fly_enabled;
+
+    logger.info() << F("Fire on the fly ") << (fly_enabled ? "on" : "off")
+            << Comms::endl;
+}
+
+// The head passes one firing column per Y step at most, so Y must not step
+// faster than the cartridge can fire whole columns.
+void fly_update_speed_limit(void) {
+    uint32_t columns_per_second = cartridge_max_frequency() / CARTRIDGE_ADDRESSES;
+
+    y_axis.set_max_speed(columns_per_second * 60 / Axis::steps_per_mm);
+}
+
+void fly_run(void) {
+    if(x_axis.moving()) {
+        x_axis.run();
+    }
+
+    if(y_axis.moving()) {
+        y_axis.run();
+    }
+}
+
+void fly_drain(void) {
+    // Y slows down into the end of what is queued by itself, and the queued
+    // columns fire by position on the way there.
+    while(!firing_queue.empty()) {
+        if(!y_axis.moving()) {
+            // Nothing left to carry the head to the remaining positions.
+            firing_queue.service(y_axis.get_current_position());
+
+            if(!firing_queue.empty()) {
+                logger.warn() << F("Dropping ") << firing_queue.count()
+                        << F(" columns, head stopped at ")
+                        << y_axis.get_current_position() << Comms::endl;
+                firing_queue.clear();
+            }
+
+            break;
+        }
+
+        fly_run();
+    }
+
+    y_axis.wait_for_move();
+
+    // The head is stopped anyway, a good time to save busy counters
+    nozzles_flush_if_needed();
+}
+
+void fly_move(const char axis_id, long steps) {
+    if(!fly_enabled || toupper(axis_id) != Axis::Y || steps == 0) {
+        fly_drain();
+        move(axis_id, steps);
+        return;
+    }
+
+    bool forwards = y_axis.get_desired_position() > y_axis.get_current_position();
+
+    // Firings already queued lie behind a change of direction.
+    if(y_axis.moving() && forwards != (steps > 0)) {
+        fly_drain();
+    }
+
+    // A column gathered while the head stood still is fired before it leaves.
+    if(!y_axis.moving()) {
+        firing_queue.service(y_axis.get_current_position());
+    }
+
+    y_axis.extend_move((int32_t)steps);
+}
+
+void fly_fire(char *spec) {
+    if(!fly_enabled) {
+        fire_spec(spec);
+        return;
+    }
+
+    byte a, f1, f2;
+
+    hex_decode_spec(spec, &a, &f1, &f2);
+
+    if(cartridge_address_slot(a) >= CARTRIDGE_ADDRESSES) {
+        // Not part of a column, fire it where it stands
+        fly_drain();
+        fire_head(f1, a, f2, a);
+        nozzles_flush_if_needed();
+        return;
+    }
+
+    // A long stroke can take a counter past the threshold with no drain
+    // before it overflows. Stop and flush rather than lose the counts.
+    if(nozzle_flush_needed) {
+        fly_drain();
+    }
+
+    while(!firing_queue.add(y_axis.get_desired_position(), f1, a, f2)) {
+        fly_run();
+
+        if(!y_axis.moving()) {
+            fly_drain();
+        }
+    }
 }
 
 void fire_command(void) {
@@ -388,24 +509,56 @@ void fire_command(void) {
     fire_spec(spec);
 }
 
+void pulse_command(void) {
+    char *arg = serial_command.next();
+
+    if(arg) {
+        uint8_t width = atoi(arg);
+
+        arg = serial_command.next();
+
+        if(arg == NULL) {
+            logger.error(F("Missing recovery time"));
+            return;
+        }
+
+        uint16_t recovery = atoi(arg);
+
+        if(!cartridge_set_timing(width, recovery)) {
+            logger.error(F("Bad firing timing"));
+            return;
+        }
+
+        fly_update_speed_limit();
+    }
+
+    logger.info() << F("Pulse ") << cartridge_pulse_width() << F(" us, recovery ")
+            << cartridge_recovery_time() << F(" us, max ")
+            << cartridge_max_frequency() << F(" firings/s") << Comms::endl;
+}
+
+// draw fires as it steps rather than through the fire-on-the-fly queue: it
+// takes either axis, and a rate above one fires the same address several
+// times at a position, where the queue holds one column per position. It
+// is for trying out a cartridge by hand, not for printing.
 void draw_command(void) {
     char *spec = serial_command.next();
 
     if(spec == NULL) {
-        logger.error("Missing firing parameter");
+        logger.error(F("Missing firing parameter"));
         return;
     }
 
     char *srate = serial_command.next();
     if(srate == NULL) {
-        logger.error("Missing firing rate");
+        logger.error(F("Missing firing rate"));
         return;
     }
 
     char *arg = serial_command.next();
 
     if(arg == NULL) {
-        logger.error("Missing axis parameter");
+        logger.error(F("Missing axis parameter"));
         return;
     }
 
@@ -414,7 +567,7 @@ void draw_command(void) {
     arg = serial_command.next();
 
     if(arg == NULL) {
-        logger.error("Missing steps parameter");
+        logger.error(F("Missing steps parameter"));
         return;
     }
 
@@ -423,13 +576,16 @@ void draw_command(void) {
 
     Axis *axis = axis_from_id(axis_id);
     if (axis == NULL) {
-        logger.error("Bad axis");
+        logger.error(F("Bad axis"));
         return;
     }
 
-    axis->move_incremental(steps);
+    // Nothing queued may go off during the line
+    fly_drain();
+
+    axis->move_incremental((int32_t)steps);
 
-    logger.info() << "Firing " << spec << " at rate " << rate << Comms::endl;
+    logger.info() << F("Firing ") << spec << F(" at rate ") << rate << Comms::endl;
 
     float acc = 0;
     while(axis->moving()) {
@@ -444,8 +600,8 @@ void draw_command(void) {
 }
 
 void print_command(void) {
-    if (!sd_initialized)
-        init_sd_command();
+    if (!sd_initialized && !sd_begin(false))
+        return;
     char *arg;
 
     static char filename[32] = "output.hex";
@@ -455,7 +611,7 @@ void print_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.info("No filename supplied, using 'output.hex'");
+        logger.info(F("No filename supplied, using 'output.hex'"));
     } else {
         strcpy(filename, arg);
     }
@@ -466,17 +622,17 @@ void print_command(void) {
         passes = atoi(arg);
     }
 
-    logger.info() << "Printing '" << filename << "'" << Comms::endl;
+    logger.info() << F("Printing '") << filename << F("'") << Comms::endl;
 
     for(int pass = 0; pass < passes; pass++) {
-        logger.info() << "Pass " << (pass + 1) << " of " << passes << Comms::endl;
+        logger.info() << F("Pass ") << (pass + 1) << F(" of ") << passes << Comms::endl;
 
-        bool result = readFile(filename);
+        readFile(filename);
 
         if(0) {
             long x_delta = 6500 + x_size;
 
-            logger.info() << "x_delta: " << x_delta << Comms::endl;
+            logger.info() << F("x_delta: ") << x_delta << Comms::endl;
             logger.info() << -6500 - x_size << Comms::endl;
 
             move('X', -6500 - x_size);
@@ -495,25 +651,259 @@ void print_command(void) {
         }
     }
 
-    logger.info("Print complete. Enjoy your circuit!");
+    nozzles_flush();
+
+    logger.info(F("Print complete. Enjoy your circuit!"));
+}
+
+void nozzles_command(void) {
+    char *arg = serial_command.next();
+
+    if(arg && !strcmp(arg, "reset")) {
+        arg = serial_command.next();
+
+        if(arg == NULL || toupper(arg[0]) == 'R') {
+            nozzles_reset(NOZZLES_RIGHT);
+        }
+
+        if(arg == NULL || toupper(arg[0]) == 'L') {
+            nozzles_reset(NOZZLES_LEFT);
+        }
+
+        return;
+    }
+
+    nozzles_flush();
+
+    // One line per cartridge and address, counts for primitives 1 to 8
+    for(uint8_t side = NOZZLES_RIGHT; side <= NOZZLES_LEFT; side++) {
+        for(uint8_t address = 0; address < 16; address++) {
+            uint8_t slot = cartridge_address_slot(address);
+
+            if(slot >= CARTRIDGE_ADDRESSES) {
+                continue;
+            }
+
+            LoggerWrapper<Logger::Info> &info = logger.info()
+                    << (side == NOZZLES_RIGHT ? "R " : "L ")
+                    << "0123456789ABCDEF"[address] << F(":");
+
+            for(uint8_t primitive = 0; primitive < NOZZLES_PRIMITIVES; primitive++) {
+                info << F(" ") << nozzles_total(side, slot, primitive);
+            }
+
+            info << Comms::endl;
+        }
+    }
 }
 
 void print_ram(void) {
     uint16_t used = ram_used();
     double utilisation = ram_utilisation();
 
-    Serial.print("Using ");
+    Serial.print(F("Using "));
     Serial.print(used);
-    Serial.print(" bytes out of 8192 (");
+    Serial.print(F(" bytes out of 8192 ("));
     Serial.print(utilisation);
-    Serial.println("%)");
+    Serial.println(F("%)"));
+}
+
+static uint16_t print_static(const __FlashStringHelper *name, uint16_t bytes) {
+    logger.info() << F("  ") << name << F(": ") << bytes << Comms::endl;
+
+    return bytes;
+}
+
+// mem prints where the RAM has gone: static data per subsystem, the heap
+// and the deepest the stack has been since boot or the last mem reset.
+void mem_command(void) {
+    char *arg = serial_command.next();
+
+    if (arg != NULL && strcmp(arg, "reset") == 0) {
+        stack_repaint();
+        return;
+    }
+
+    uint16_t statics = static_data() + static_bss();
+
+    logger.info() << F("Static: ") << statics << F(" (data ") << static_data()
+            << F(", bss ") << static_bss() << F(")") << Comms::endl;
+
+    uint16_t listed = 0;
+    listed += print_static(F("SD card"), sizeof(sd) + sdcard_cache_bytes());
+    listed += print_static(F("I/O arena"), ARENA_SIZE);
+    listed += print_static(F("Nozzles"), sizeof(nozzle_pending));
+    listed += print_static(F("Motion"), sizeof(x_axis) + sizeof(y_axis) +
+            sizeof(a_motor) + sizeof(b_motor) + sizeof(rollers));
+    listed += print_static(F("Commands"), sizeof(serial_command));
+    listed += print_static(F("Profiler"), profile_bytes());
+    listed += print_static(F("Trace"), trace_bytes());
+    listed += print_static(F("Settings"), sizeof(global_settings) +
+            sizeof(default_settings));
+    print_static(F("Other"), statics > listed ? statics - listed : 0);
+
+    logger.info() << F("Arena: ") << arena_used() << F(" now, ") << arena_peak()
+            << F(" peak") << Comms::endl;
+    logger.info() << F("Heap: ") << heap_used() << Comms::endl;
+    logger.info() << F("Stack: ") << stack_current() << F(" now, ")
+            << stack_peak() << F(" peak") << Comms::endl;
+    logger.info() << F("Never used: ") << stack_unused() << F(" of ")
+            << RAM_TOTAL << Comms::endl;
+}
+
+// prof prints the time spent per pass of the main loop, per step, per card
+// block, per job line parsed and per firing, since boot or the last
+// prof reset.
+void prof_command(void) {
+    char *arg = serial_command.next();
+
+    if (arg != NULL && strcmp(arg, "reset") == 0) {
+        profile_reset();
+        return;
+    }
+
+    profile_print();
 }
 
+// jitter prints how late steps have been against the speed asked for, per
+// axis, since the last print started or jitter reset.
+void jitter_command(void) {
+#if !JITTER
+    logger.info(F("Built without JITTER"));
+    return;
+#endif
+
+    char *arg = serial_command.next();
+
+    if (arg != NULL && strcmp(arg, "reset") == 0) {
+        x_axis.reset_jitter();
+        y_axis.reset_jitter();
+        return;
+    }
+
+    x_axis.print_jitter();
+    y_axis.print_jitter();
+}
+
+// trace sends the last few moves, firings, card reads, limit stops,
+// brown-outs and commands in binary, for tracedump.py to show as a timeline.
+// trace reset empties it.
+void trace_command(void) {
+    char *arg = serial_command.next();
+
+    if (arg != NULL && strcmp(arg, "reset") == 0) {
+        trace_reset();
+        return;
+    }
+
+    trace_dump();
+}
+
+static void print_hex32(uint32_t value) {
+    for (int i = 0; i < 8; i++)
+    {
+        uint8_t v = (value >> (28 - i*4)) & 0xf;
+        Serial.write(v >= 10 ? v + 'a' - 10 : v + '0');
+    }
+}
+
+// One line per catalogued job for the host,
+// job,NAME,size,djb2,crc32,min_x,min_y,max_x,max_y,last_printed
+// with unknown fields left empty, then jobs,<listed>,<matching>.
+static void ls_catalogue(void) {
+    char *arg = serial_command.next();
+    int16_t first = arg ? atoi(arg) : 0;
+    arg = serial_command.next();
+    int16_t count = arg ? atoi(arg) : 0x7fff;
+    char *filter = serial_command.next();
+    if (filter)
+        for (char *p = filter; *p; p++)
+            *p = toupper(*p);
+
+    SdBaseFile catalogue;
+    JobRecord record;
+    int16_t matching = 0;
+    int16_t listed = 0;
+
+    if (catalogue_open(sd.vwd(), &catalogue))
+    {
+        while (catalogue_next(&catalogue, &record))
+        {
+            if (filter && !strstr(record.name, filter))
+                continue;
+
+            if (matching++ < first || listed >= count)
+                continue;
+
+            listed++;
+
+            Serial.print(F("job,"));
+            Serial.print(record.name);
+            Serial.print(',');
+            Serial.print(record.size);
+            Serial.print(',');
+            if (record.flags & JOB_DJB2)
+                print_hex32(record.djb2);
+            Serial.print(',');
+            if (record.flags & JOB_CRC32)
+                print_hex32(record.crc32);
+            if (record.flags & JOB_BOUNDS)
+            {
+                Serial.print(',');
+                Serial.print(record.min_x);
+                Serial.print(',');
+                Serial.print(record.min_y);
+                Serial.print(',');
+                Serial.print(record.max_x);
+                Serial.print(',');
+                Serial.print(record.max_y);
+                Serial.print(',');
+            }
+            else
+                Serial.print(F(",,,,,"));
+            Serial.println(record.last_printed);
+        }
+
+        catalogue.close();
+    }
+
+    Serial.print(F("jobs,"));
+    Serial.print(listed);
+    Serial.print(',');
+    Serial.println(matching);
+}
+
+// ls lists the print files in the directory, ls -r brings the job
+// catalogue up to date with it and ls -m [first [count [filter]]] lists
+// the catalogue.
 void ls_command(void) {
-    if (!sd_initialized)
-        init_sd_command();
+    if (!sd_initialized && !sd_begin(false))
+        return;
+
+    char *arg = serial_command.next();
+
+    if (arg && !strcmp(arg, "-m"))
+    {
+        ls_catalogue();
+        return;
+    }
+
+    if (arg && !strcmp(arg, "-r"))
+    {
+        int16_t jobs = catalogue_rescan(sd.vwd());
+        if (jobs < 0)
+            logger.error(F("Could not update the catalogue."));
+        else
+            logger.info() << jobs << F(" jobs catalogued.") << Comms::endl;
+        return;
+    }
+
+    ArenaBuffer buffer(256);
+    if (!buffer.data)
+        return;
+
     SdFile file;
-    char name[256];
+    char *name = (char*)buffer.data;
 
     sd.vwd()->rewind();
 
@@ -530,44 +920,76 @@ void ls_command(void) {
     }
 
     if (count == 0)
-        logger.info("No files.");
+        logger.info(F("No files."));
 }
 
 void rm_command(void) {
-    if (!sd_initialized)
-        init_sd_command();
+    if (!sd_initialized && !sd_begin(false))
+        return;
     char *arg = serial_command.next();
+
+    SdFile file;
+    if (file.open(arg))
+    {
+        char name[13];
+        file.getFilename(name);
+        file.close();
+        catalogue_remove(sd.vwd(), name);
+    }
+
     sd.remove(arg);
 }
 
 void md5_command(void) {
-    if (!sd_initialized)
-        init_sd_command();
+    if (!sd_initialized && !sd_begin(false))
+        return;
     char *arg = serial_command.next();
 
     SdFile file;
     file.open(arg);
 
     if (!file.isOpen()) {
-        Serial.print("File could not be opened: ");
+        Serial.print(F("File could not be opened: "));
         Serial.println(arg);
 
         return;
     }
 
-    byte block[1024];
-    MD5_CTX md5;
-    MD5_Init(&md5);
-    for (;;)
+    ArenaBuffer buffer(1024);
+    if (!buffer.data)
     {
-        int n = file.read(block, sizeof(block));
-        if (n <= 0)
-            break;
-        MD5_Update(&md5, block, (unsigned int)n);
+        file.close();
+        return;
+    }
+
+    byte *block = buffer.data;
+    JobRecord record;
+    if (catalogue_find(sd.vwd(), &file, &record) && (record.flags & JOB_MD5))
+    {
+        file.close();
+        memcpy(block, record.md5, sizeof(record.md5));
+    }
+    else
+    {
+        MD5_CTX md5;
+        MD5_Init(&md5);
+        for (;;)
+        {
+            int n = file.read(block, buffer.size);
+            if (n <= 0)
+                break;
+            MD5_Update(&md5, block, (unsigned int)n);
+        }
+        MD5_Final(block, &md5);
+
+        if (!catalogue_find(sd.vwd(), &file, &record))
+            catalogue_describe(&file, &record);
+        memcpy(record.md5, block, sizeof(record.md5));
+        record.flags |= JOB_MD5;
+        file.close();
+        catalogue_store(sd.vwd(), &record);
     }
-    file.close();
 
-    MD5_Final(block, &md5);
     int i;
     for (i = 0; i < 16; i++)
     {
@@ -582,27 +1004,36 @@ void md5_command(void) {
 }
 
 void djb2_command(void) {
-    if (!sd_initialized)
-        init_sd_command();
+    if (!sd_initialized && !sd_begin(false))
+        return;
     char *arg = serial_command.next();
 
     SdFile file;
     file.open(arg);
 
     if (!file.isOpen()) {
-        Serial.print("File could not be opened: ");
+        Serial.print(F("File could not be opened: "));
         Serial.println(arg);
 
         return;
     }
 
-    byte block[1024];
+    ArenaBuffer buffer(1024);
+    if (!buffer.data)
+    {
+        file.close();
+        return;
+    }
+
+    byte *block = buffer.data;
     uint32_t hash = 5381;
     bool bFirst = true;
+    bool cached = false;
+    JobRecord record;
 
     for (;;)
     {
-        int len = file.read(block, sizeof(block));
+        int len = file.read(block, buffer.size);
         if (len <= 0)
             break;
 
@@ -616,6 +1047,14 @@ void djb2_command(void) {
             return;
         }
 
+        if (bFirst && catalogue_find(sd.vwd(), &file, &record) &&
+                (record.flags & JOB_DJB2))
+        {
+            hash = record.djb2;
+            cached = true;
+            break;
+        }
+
         bFirst = false;
 
         int pos;
@@ -626,6 +1065,15 @@ void djb2_command(void) {
         }
     }
 
+    if (!cached)
+    {
+        if (!catalogue_find(sd.vwd(), &file, &record))
+            catalogue_describe(&file, &record);
+        record.djb2 = hash;
+        record.flags |= JOB_DJB2;
+        catalogue_store(sd.vwd(), &record);
+    }
+
     file.close();
 
     int i;
@@ -638,11 +1086,309 @@ void djb2_command(void) {
     Serial.println((char*)block);
 }
 
+// CRC-32 of a file, from the catalogue when recv has already worked it
+// out. Much cheaper than md5 to check a whole file on the card.
+void crc32_command(void) {
+    if (!sd_initialized && !sd_begin(false))
+        return;
+    char *arg = serial_command.next();
+
+    SdFile file;
+    file.open(arg);
+
+    if (!file.isOpen()) {
+        Serial.print(F("File could not be opened: "));
+        Serial.println(arg);
+
+        return;
+    }
+
+    JobRecord record;
+    if (!catalogue_find(sd.vwd(), &file, &record))
+        catalogue_describe(&file, &record);
+
+    if (!(record.flags & JOB_CRC32))
+    {
+        BlockReader stream;
+        ArenaBuffer stream_buffer(BLOCK_SIZE);
+        ArenaBuffer buffer(BLOCK_SIZE);
+        uint32_t crc = CRC32_INIT;
+        uint32_t total = 0;
+        int n;
+
+        if (buffer.data && stream.open(sd.vol(), &file, stream_buffer.data))
+        {
+            while ((n = stream.read(buffer.data, buffer.size)) > 0)
+            {
+                crc = crc32_update(crc, buffer.data, n);
+                total += n;
+            }
+            stream.close();
+        }
+
+        if (total != file.fileSize())
+        {
+            logger.error() << F("Read ") << total << F(" of ") << file.fileSize()
+                    << F(" bytes") << Comms::endl;
+            file.close();
+            return;
+        }
+
+        record.crc32 = crc32_final(crc);
+        record.flags |= JOB_CRC32;
+        catalogue_store(sd.vwd(), &record);
+    }
+
+    file.close();
+
+    print_hex32(record.crc32);
+    Serial.println();
+}
+
+// Reads a whole file through SdBaseFile::read() and then through the
+// streaming BlockReader and reports the sustained rate of each.
+void sdbench_command(void) {
+    if (!sd_initialized && !sd_begin(false))
+        return;
+    char *arg = serial_command.next();
+
+    if(arg == NULL) {
+        logger.error(F("Missing file name"));
+        return;
+    }
+
+    SdFile file;
+    file.open(arg);
+
+    if (!file.isOpen()) {
+        Serial.print(F("File could not be opened: "));
+        Serial.println(arg);
+
+        return;
+    }
+
+    ArenaBuffer buffer(BLOCK_SIZE);
+    ArenaBuffer stream_buffer(BLOCK_SIZE);
+    if (!buffer.data || !stream_buffer.data) {
+        file.close();
+        return;
+    }
+
+    byte *block = buffer.data;
+    uint32_t size = file.fileSize();
+
+    uint32_t start = millis();
+    while(file.read(block, BLOCK_SIZE) > 0);
+    uint32_t cached = millis() - start;
+
+    file.rewind();
+
+    BlockReader stream;
+    uint32_t total = 0;
+
+    start = millis();
+    if(stream.open(sd.vol(), &file, stream_buffer.data)) {
+        int n;
+
+        while((n = stream.read(block, BLOCK_SIZE)) > 0) {
+            total += n;
+        }
+    }
+    uint32_t streamed = millis() - start;
+    uint16_t fragments = stream.fragments;
+
+    stream.close();
+    file.close();
+
+    if(total != size) {
+        logger.error() << F("Stream read ") << total << F(" of ") << size
+                << F(" bytes") << Comms::endl;
+        return;
+    }
+
+    // bytes per millisecond is roughly KB/s
+    logger.info() << F("Read ") << size << F(" bytes, SPI clock ")
+            << (F_CPU / sdcard_divisor() / 1000) << F(" kHz") << Comms::endl;
+    logger.info() << F("Single block: ") << cached << F(" ms, ")
+            << (cached ? size / cached : 0) << F(" KB/s") << Comms::endl;
+    logger.info() << F("Streamed:     ") << streamed << F(" ms, ")
+            << (streamed ? size / streamed : 0) << F(" KB/s, ")
+            << fragments << F(" fragments") << Comms::endl;
+}
+
+// Cycle counts of the hot paths, for comparing builds. Each call is timed
+// on the HAL cycle counter with interrupts held off, so the numbers are
+// exact to the cycle and the same from run to run. The motors are disabled
+// while the axis is stepped, and positions are put back afterwards.
+#if CYCLES
+
+struct CycleBench {
+    char name[24];
+    uint16_t calls;
+    void (*prepare)(uint16_t call);
+    void (*run)(void);
+};
+
+static uint8_t cycles_data[64];
+static char cycles_line[] = "z,02,z,,zC3,z,,,,z01,z,,\n";
+static char cycles_decoded[13 * 8];
+static MD5_CTX cycles_md5;
+
+static void cycles_nothing(void) {
+}
+
+static void cycles_axis_prepare(uint16_t call) {
+    if (call == 0)
+        x_axis.move_incremental((int32_t)(limit_x_positive() ? -1000 : 1000));
+}
+
+static void cycles_axis_idle(void) {
+    y_axis.run();
+}
+
+static void cycles_axis_moving(void) {
+    x_axis.run();
+}
+
+// Fast enough that the step is always due once prepare has waited out
+// the step delay, so every call takes a step rather than returning early
+static void cycles_step_prepare(uint16_t call) {
+    if (call == 0)
+        b_motor.set_speed(30000);
+    delayMicroseconds(b_motor.get_step_delay() + 1);
+}
+
+static void cycles_step(void) {
+    b_motor.step();
+}
+
+static void cycles_set_speed(void) {
+    b_motor.set_speed(1234);
+}
+
+static void cycles_fire_prepare(uint16_t /*call*/) {
+    // Outside the timing, and with interrupts, so recovery can end
+    while (!cartridge_ready())
+        hal_poll();
+}
+
+static void cycles_fire(void) {
+    // An address with no primitives, so nothing is printed
+    char spec[] = "80000";
+    fire_spec(spec);
+}
+
+static void cycles_decb_prepare(uint16_t call) {
+    if (call == 0)
+        decb_init();
+}
+
+static void cycles_decb(void) {
+    int inoff = 0;
+    int outlen = sizeof(cycles_decoded);
+    decb(cycles_line, &inoff, sizeof(cycles_line) - 1, cycles_decoded, &outlen);
+}
+
+static void cycles_command_prepare(uint16_t call) {
+    if (call % 16 == 0)
+        serial_command.clearBuffer();
+}
+
+static void cycles_add_byte(void) {
+    serial_command.add_byte('x');
+}
+
+static void cycles_crc8(void) {
+    CRC8(cycles_data, 32);
+}
+
+static void cycles_md5_prepare(uint16_t call) {
+    if (call == 0)
+        MD5_Init(&cycles_md5);
+}
+
+static void cycles_md5_update(void) {
+    MD5_Update(&cycles_md5, cycles_data, 64);
+}
+
+static const CycleBench cycle_benches[] PROGMEM = {
+    { "Axis::run (idle)",        64, NULL,                   cycles_axis_idle },
+    { "Axis::run (moving)",      64, cycles_axis_prepare,    cycles_axis_moving },
+    { "Stepper::step",           64, cycles_step_prepare,    cycles_step },
+    { "Stepper::set_speed",      64, NULL,                   cycles_set_speed },
+    { "fire_spec",               16, cycles_fire_prepare,    cycles_fire },
+    { "decb (13 firings)",       16, cycles_decb_prepare,    cycles_decb },
+    { "SerialCommand::add_byte", 64, cycles_command_prepare, cycles_add_byte },
+    { "CRC8 (32 bytes)",         64, NULL,                   cycles_crc8 },
+    { "MD5_Update (64 bytes)",   16, cycles_md5_prepare,     cycles_md5_update },
+};
+
+static uint32_t cycles_count(const CycleBench *bench) {
+    uint32_t cycles = 0;
+
+    for (uint16_t call = 0; call < bench->calls; call++) {
+        if (bench->prepare)
+            bench->prepare(call);
+
+        uint8_t state = hal_irq_save();
+        uint16_t start = hal_cycles();
+        bench->run();
+        cycles += (uint16_t)(hal_cycles() - start);
+        hal_irq_restore(state);
+    }
+
+    return cycles;
+}
+
+void cycles_command(void) {
+    for (uint8_t i = 0; i < sizeof(cycles_data); i++)
+        cycles_data[i] = i * 37;
+
+    bool a_enabled = digitalRead(STEPPER_A_ENABLE_PIN) == LOW;
+    bool b_enabled = digitalRead(STEPPER_B_ENABLE_PIN) == LOW;
+    uint32_t x_position = x_axis.current_position;
+    a_motor.enable(false);
+    b_motor.enable(false);
+
+    uint16_t counter = hal_cycles_start();
+
+    // Timing and call overhead, taken off every result
+    CycleBench empty = { "", 64, NULL, cycles_nothing };
+    uint32_t overhead = cycles_count(&empty) / empty.calls;
+
+    logger.info(F("Cycles per call"));
+
+    for (uint8_t i = 0; i < sizeof(cycle_benches) / sizeof(cycle_benches[0]); i++) {
+        CycleBench bench;
+        memcpy_P(&bench, &cycle_benches[i], sizeof(bench));
+        uint32_t cycles = cycles_count(&bench) / bench.calls;
+
+        cycles = cycles > overhead ? cycles - overhead : 0;
+
+        Serial.print(bench.name);
+        for (uint8_t n = strlen(bench.name); n < 26; n++)
+            Serial.print(' ');
+        Serial.println(cycles);
+    }
+
+    hal_cycles_stop(counter);
+
+    x_axis.hold();
+    x_axis.current_position = x_position;
+    x_axis.hold();
+    b_motor.set_speed(500);
+    a_motor.enable(a_enabled);
+    b_motor.enable(b_enabled);
+}
+
+#endif
+
 int onlinePrint(byte *buf, int buflen)
 {
     byte *p = buf;
     while (p < buf + buflen)
     {
+        uint16_t start = profile_begin();
         byte *pe = p;
         while (pe < buf + buflen && *pe != '\n')
             pe++;
@@ -659,11 +1405,13 @@ int onlinePrint(byte *buf, int buflen)
             char axis = p[2];
 
             long steps = atol((char*)p + 4);
-            move(axis, steps);
+            profile_end(PROFILE_PARSE, start);
+            fly_move(axis, steps);
         }
         else if (p[0] == 'F')
         {
-            fire_spec((char*)p+2);
+            profile_end(PROFILE_PARSE, start);
+            fly_fire((char*)p+2);
         }
 
         p = pe + 1;
@@ -672,6 +1420,136 @@ int onlinePrint(byte *buf, int buflen)
     return buf + buflen - p;
 }
 
+#define RECV_TIMEOUT 1000
+
+// What recv learns about the file it writes, for the job catalogue. djb2,
+// CRC-32 and the extent are cheap enough to do as each block is verified, MD5 of
+// a written-behind block is done 64 bytes at a time while waiting for
+// serial data.
+struct RecvDigest {
+    MD5_CTX md5;
+    uint32_t djb2;
+    uint32_t crc32;
+    JobScan scan;
+    const byte *pending;
+    uint16_t left;
+};
+
+static void recv_digest_init(RecvDigest *digest) {
+    MD5_Init(&digest->md5);
+    digest->djb2 = 5381;
+    digest->crc32 = CRC32_INIT;
+    catalogue_scan_init(&digest->scan);
+    digest->left = 0;
+}
+
+static void recv_digest_scan(RecvDigest *digest, const byte *data, int len) {
+    uint32_t hash = digest->djb2;
+    for (int n = 0; n < len; n++)
+        hash = ((hash << 5) + hash) + data[n];
+    digest->djb2 = hash;
+    digest->crc32 = crc32_update(digest->crc32, data, len);
+    catalogue_scan(&digest->scan, data, len);
+}
+
+static void recv_digest_service(RecvDigest *digest) {
+    uint16_t n = digest->left < 64 ? digest->left : 64;
+    MD5_Update(&digest->md5, digest->pending, n);
+    digest->pending += n;
+    digest->left -= n;
+}
+
+static void recv_digest_flush(RecvDigest *digest) {
+    while (digest->left > 0)
+        recv_digest_service(digest);
+}
+
+static void recv_digest_update(RecvDigest *digest, const byte *data, int len) {
+    recv_digest_flush(digest);
+    recv_digest_scan(digest, data, len);
+    MD5_Update(&digest->md5, data, len);
+}
+
+// As above, but data has to stay put until the MD5 has caught up.
+static void recv_digest_defer(RecvDigest *digest, const byte *data, int len) {
+    recv_digest_flush(digest);
+    recv_digest_scan(digest, data, len);
+    digest->pending = data;
+    digest->left = len;
+}
+
+// Serial.readBytes(), but while it waits it keeps feeding blocks queued on
+// the writer to the card and catching up on hashing, so the previous block
+// is committed while the next one arrives. When printing online it also
+// keeps the head moving through what is already queued.
+static int recv_read_bytes(byte *dst, int length, BlockWriter *writer,
+                           RecvDigest *digest) {
+    int count = 0;
+    uint32_t last = millis();
+#if TELEMETRY
+    uint32_t waiting = 0;
+    bool moving = x_axis.moving() || y_axis.moving();
+#endif
+
+    while (count < length)
+    {
+        int c = Serial.read();
+        if (c >= 0)
+        {
+            dst[count++] = c;
+            last = millis();
+#if TELEMETRY
+            if (waiting)
+            {
+                time_total_add(&telemetry.serial, micros() - waiting);
+                waiting = 0;
+            }
+#endif
+            continue;
+        }
+
+#if TELEMETRY
+        if (!waiting)
+            waiting = micros() | 1;
+#endif
+
+        fly_run();
+
+        bool busy = false;
+        if (writer->pending())
+        {
+            writer->service();
+            busy = true;
+        }
+        if (digest->left > 0)
+        {
+            recv_digest_service(digest);
+            busy = true;
+        }
+        if (!busy && millis() - last >= RECV_TIMEOUT)
+            break;
+    }
+
+#if TELEMETRY
+    if (waiting)
+        time_total_add(&telemetry.serial, micros() - waiting);
+
+    // The head ran out of queued moves before the block was in
+    if (moving && !x_axis.moving() && !y_axis.moving())
+        telemetry.underruns++;
+#endif
+
+    return count;
+}
+
+// A contiguous file is full size from the start, so one that is left behind
+// half written would pass for the whole thing.
+static void recv_abandon(SdFile *file, BlockWriter *writer) {
+    writer->close();
+    if (file->isOpen())
+        file->remove();
+}
+
 void recv_command(void) {
     char *arg = serial_command.next();
     uint32_t size = 0;
@@ -682,8 +1560,8 @@ void recv_command(void) {
     bool compressed = false, online = false;
     if (!strcmp(filename, "bo") || !strcmp(filename, "o"))
         online = true;
-    else if (!sd_initialized)
-        init_sd_command();
+    else if (!sd_initialized && !sd_begin(false))
+        return;
     if (!strcmp(filename, "b") || !strcmp(filename, "bo"))
     {
         compressed = true;
@@ -691,22 +1569,48 @@ void recv_command(void) {
         decb_init();
     }
 
+#define OVERLAP 64
+    ArenaBuffer buffer(1029 + OVERLAP);
+    // Decompression output, or the block being written behind
+    ArenaBuffer buffer2(1024);
+    if (!buffer.data || !buffer2.data)
+        return;
+
+    byte *block = buffer.data;
+    byte *block2 = buffer2.data;
+
     SdFile file;
+    BlockWriter writer;
+    RecvDigest digest;
+    recv_digest_init(&digest);
     if (!online)
     {
-        file.open(filename, O_CREAT|O_WRITE|O_TRUNC);
+        // The decompressed size isn't known up front, but otherwise lay the
+        // file out in one run and stream the blocks straight to the card.
+        if (!compressed && size > 0)
+        {
+            sd.remove(filename);
+            if (file.createContiguous(sd.vwd(), filename, size))
+                writer.open(sd.vol(), &file);
+        }
+        if (!file.isOpen())
+            file.open(filename, O_CREAT|O_WRITE|O_TRUNC);
         if (!file.isOpen()) {
-            Serial.print("File could not be opened: ");
+            Serial.print(F("File could not be opened: "));
             Serial.println(filename);
             return;
         }
     }
 
-    Serial.println("Ready");
+    if (online)
+    {
+        x_axis.reset_jitter();
+        y_axis.reset_jitter();
+        telemetry_start();
+    }
+
+    Serial.println(F("Ready"));
 
-#define OVERLAP 64
-    byte block[1029 + OVERLAP];
-    byte block2[512 + OVERLAP];
     uint32_t hash = 5381;
     uint32_t pos = 0;
     int inoff = 0;
@@ -717,6 +1621,7 @@ void recv_command(void) {
         {
             // eep
             Serial.write((byte*)"J", 1);
+            recv_abandon(&file, &writer);
             return;
         }
         uint32_t nleft = size - pos;
@@ -727,15 +1632,16 @@ void recv_command(void) {
         bool paused = false;
         while (nread > 0)
         {
-            len = Serial.readBytes((char*)block + where, nread);
+            len = recv_read_bytes(block + where, nread, &writer, &digest);
             if (paused && len == 0)
                 continue;
             if (len <= 0)
                 break;
             if (len == 1 && where == inoff && block[where] == 'C')
             {
-                if (!online)
-                    file.remove();
+                if (online)
+                    firing_queue.clear();
+                recv_abandon(&file, &writer);
                 return;
             }
             if (len == 1 && where == inoff && block[where] == 'P')
@@ -757,12 +1663,13 @@ void recv_command(void) {
         }
         if (nread != 0)
         {
-            Serial.println("Errorecv");
+            Serial.println(F("Errorecv"));
             Serial.println(nread);
             Serial.println(blocksize);
             Serial.println(pos);
             Serial.println(size);
             Serial.write(block + inoff, blocksize + 5 - nread);
+            recv_abandon(&file, &writer);
             return;
         }
 
@@ -795,12 +1702,13 @@ void recv_command(void) {
             int res = KEEP_GOING;
             while (res == KEEP_GOING)
             {
-                int outlen = sizeof(block2) - outoff;
+                int outlen = buffer2.size - outoff;
                 res = decb((char*)block, &inoff, len, (char*)block2 + outoff, &outlen);
                 if (res == DECODE_ERROR)
                 {
                     // TODO: see if we can report bad block and unwind
                     Serial.write((byte*)"F", 1);
+                    recv_abandon(&file, &writer);
                     return;
                 }
                 if (online)
@@ -812,6 +1720,7 @@ void recv_command(void) {
                 else
                 {
                     file.write(block2, outlen);
+                    recv_digest_update(&digest, block2, outlen);
                 }
             }
 
@@ -822,13 +1731,34 @@ void recv_command(void) {
         {
             if (online)
             {
-                int unused = onlinePrint(block, blocksize);
-                memmove(block, block + blocksize - unused, unused);
+                // After the partial line held over from the last block
+                int unused = onlinePrint(block, len);
+                memmove(block, block + len - unused, unused);
                 inoff = unused;
             }
+            else if (writer.is_open())
+            {
+                // Ack as soon as the previous block is down and this one is
+                // queued. The last ack waits for the whole file, and a
+                // failed write is reported with W in place of the ack.
+                bool written = writer.flush();
+                recv_digest_flush(&digest);
+                memcpy(block2, block, blocksize);
+                recv_digest_defer(&digest, block2, blocksize);
+                written = written && writer.queue(block2, blocksize);
+                if (written && pos == size)
+                    written = writer.flush() && writer.close();
+                if (!written)
+                {
+                    Serial.write((byte*)"W", 1);
+                    recv_abandon(&file, &writer);
+                    return;
+                }
+            }
             else
             {
                 file.write(block, blocksize);
+                recv_digest_update(&digest, block, blocksize);
             }
         }
 
@@ -836,7 +1766,40 @@ void recv_command(void) {
     }
 
     if (!online)
+    {
+        // The plain path's last block only reaches the card here
+        if (!writer.close() || !file.sync())
+        {
+            logger.error() << F("Writing ") << filename << F(" failed")
+                    << Comms::endl;
+            recv_abandon(&file, &writer);
+            return;
+        }
+
+        JobRecord record;
+        if (catalogue_describe(&file, &record))
+        {
+            recv_digest_flush(&digest);
+            MD5_Final(record.md5, &digest.md5);
+            record.djb2 = digest.djb2;
+            record.crc32 = crc32_final(digest.crc32);
+            record.flags = JOB_DJB2 | JOB_MD5 | JOB_CRC32;
+            catalogue_scan_bounds(&digest.scan, &record);
+            catalogue_store(sd.vwd(), &record);
+        }
+
         file.close();
+    }
+    else
+    {
+        fly_drain();
+        nozzles_flush();
+        x_axis.print_jitter();
+        y_axis.print_jitter();
+
+        telemetry_report("online", size,
+                x_axis.jitter.late_steps + y_axis.jitter.late_steps);
+    }
 }
 
 void echo_command(void) {
@@ -845,18 +1808,21 @@ void echo_command(void) {
     while (*arg >= '0' && *arg <= '9')
         size = size * 10 + (*arg++ - '0');
 
-    byte block[1028 + OVERLAP];
-    int nread = size < sizeof(block) ? size : sizeof(block);
-    int len = Serial.readBytes((char*)block, nread);
-    logger.info() << "Read " << len << " bytes." << Comms::endl;
-    Serial.write(block, len);
+    ArenaBuffer buffer(1028 + OVERLAP);
+    if (!buffer.data)
+        return;
+
+    int nread = size < buffer.size ? size : buffer.size;
+    int len = Serial.readBytes((char*)buffer.data, nread);
+    logger.info() << F("Read ") << len << F(" bytes.") << Comms::endl;
+    Serial.write(buffer.data, len);
 }
 
 
 void help_command(void) {
-    comms.println("Press p to print output.hex");
-    comms.println("S to stop, P to pause, R to resume, c to calibrate.");
-    comms.println("Additional commands: ");
+    comms.println(F("Press p to print output.hex"));
+    comms.println(F("S to stop, P to pause, R to resume, c to calibrate."));
+    comms.println(F("Additional commands: "));
     serial_command.installed_commands();
     comms.println();
 }
@@ -866,13 +1832,13 @@ void unknown_command(const char *cmd) {
         return;
     if (!strcmp(cmd, "notacmd"))
         return;
-    logger.error() << "Unknown command '" << cmd << "'." << Comms::endl;
+    logger.error() << F("Unknown command '") << cmd << F("'.") << Comms::endl;
 }
 
 #include "version.h"
 
 void version_command(void) {
-    logger.info() << "Version [" << version_string << "]" << Comms::endl;
+    logger.info() << F("Version [") << version_string << F("]") << Comms::endl;
 }
 
 void printer_number_command(void) {
@@ -885,7 +1851,7 @@ void printer_number_command(void) {
         return;
     }
 
-    logger.info() << "Printer Number [" << global_settings.printerNumber << "]" << Comms::endl;
+    logger.info() << F("Printer Number [") << global_settings.printerNumber << F("]") << Comms::endl;
 }
 
 void calibrate_command(void) {
@@ -910,18 +1876,64 @@ void calibrate_loop_command(void) {
         if (!calibrate(&calibration))
             break;
 
-        logger.info() << calibration.x_axis.motor << " "
-                << calibration.x_axis.length << ", " << calibration.x_axis.motor
-                << " " << calibration.x_axis.length << Comms::endl;
+        logger.info() << calibration.x_axis.motor << F(" ")
+                << calibration.x_axis.length << F(", ") << calibration.x_axis.motor
+                << F(" ") << calibration.x_axis.length << Comms::endl;
     }
 }
 
+static bool sd_begin(bool probe) {
+    bool initialised;
+
+    // A print from the card holds a multi-block read open, and any other
+    // command to the card in the middle of it would corrupt the stream
+    if(reader.is_open()) {
+        logger.error(F("SD card is busy printing"));
+        return false;
+    }
+
+    if(probe) {
+        initialised = sdcard_probe(&sd, 53);
+    } else {
+        initialised = sdcard_initialise(&sd, 53);
+    }
+
+    if(!initialised) {
+        logger.warn(F("Failed to initialise SD card."));
+    }
+
+    return initialised;
+}
+
+// Other commands bring the card up with sd_begin(), so that the arguments
+// meant for them aren't taken here.
 void init_sd_command(void) {
-    if(!sd.begin(53, SPI_HALF_SPEED)) {
-        logger.warn("Failed to initialise SD card.");
+    char *arg = serial_command.next();
+
+    if(!sd_begin(arg != NULL && strcmp(arg, "probe") == 0)) {
+        return;
+    }
+
+    if(arg != NULL) {
+        logger.info() << F("SD card SPI clock ") << (F_CPU / sdcard_divisor() / 1000)
+                << F(" kHz") << Comms::endl;
     }
 }
 
+// sdcache reports the volume cache hit rates, sdcache reset clears them.
+void sdcache_command(void) {
+    char *arg = serial_command.next();
+
+    if (arg != NULL && strcmp(arg, "reset") == 0) {
+        sdcard_reset_cache_stats();
+        return;
+    }
+
+    logger.info() << F("SD cache ") << SD_CACHE_BLOCKS << F(" blocks")
+            << Comms::endl;
+    sdcard_print_cache_stats();
+}
+
 void limit_switch_command(void) {
     print_switch_status();
 }
@@ -932,7 +1944,7 @@ void analog_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("No pin supplied");
+        logger.error(F("No pin supplied"));
         return;
     }
 
@@ -941,13 +1953,13 @@ void analog_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("No value supplied");
+        logger.error(F("No value supplied"));
         return;
     }
 
     int value = atoi(arg);
 
-    logger.info() << "Setting " << pin << " to " << value << Comms::endl;
+    logger.info() << F("Setting ") << pin << F(" to ") << value << Comms::endl;
 
     analogWrite(pin, value);
 }
@@ -958,7 +1970,7 @@ void digital_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("No pin supplied");
+        logger.error(F("No pin supplied"));
         return;
     }
 
@@ -967,13 +1979,13 @@ void digital_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("No value supplied");
+        logger.error(F("No value supplied"));
         return;
     }
 
     int value = atoi(arg);
 
-    logger.info() << "Setting " << pin << " to " << value << Comms::endl;
+    logger.info() << F("Setting ") << pin << F(" to ") << value << Comms::endl;
 
     digitalWrite(pin, value);
 }
@@ -984,7 +1996,7 @@ void red_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("No value (0 .. 255) supplied");
+        logger.error(F("No value (0 .. 255) supplied"));
         return;
     }
 
@@ -999,7 +2011,7 @@ void green_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("No value (0 .. 255) supplied");
+        logger.error(F("No value (0 .. 255) supplied"));
         return;
     }
 
@@ -1014,7 +2026,7 @@ void blue_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("No value (0 .. 255) supplied");
+        logger.error(F("No value (0 .. 255) supplied"));
         return;
     }
 
@@ -1043,15 +2055,15 @@ void rollers_command(void) {
 
   arg = serial_command.next();
 /*
-  logger.info("Got the roller command: ");
+  logger.info(F("Got the roller command: "));
   logger.info(arg);
-  logger.info("Current angle is:");
+  logger.info(F("Current angle is:"));
   logger.info(aval);
 */
 
   if(!arg) {
-    logger.error("Missing position argument");
-    logger.info("Valid options are:\n+ up\n - down\nE enable\ne disable\nr retract\nd deploy\nR Set retract pos.\nD Set deploy pos.\nangle, an integer\n");
+    logger.error(F("Missing position argument"));
+    logger.info(F("Valid options are:\n+ up\n - down\nE enable\ne disable\nr retract\nd deploy\nR Set retract pos.\nD Set deploy pos.\nangle, an integer\n"));
     return;
   }
 
@@ -1059,51 +2071,51 @@ void rollers_command(void) {
   switch(*arg)
   {
     case '+':
-      logger.info("Raising the rollers");
+      logger.info(F("Raising the rollers"));
       rollers.angle(--aval); // Smaller angles rotate up.
       break;
     case '-':
-      logger.info("lowering the rollers");
+      logger.info(F("lowering the rollers"));
       rollers.angle(++aval); // Larger angles rotate down.
       break;
     case 'E':
-      logger.info("Enabling the rollers");
+      logger.info(F("Enabling the rollers"));
       rollers.enable();
       break;
     case 'e':
-      logger.info("Disabling the rollers");
+      logger.info(F("Disabling the rollers"));
       rollers.disable();
       break;
     case 'r':
-      logger.info("Retracting the rollers");
+      logger.info(F("Retracting the rollers"));
       rollers.retract();
       break;
     case 'd':
-      logger.info("Deploying the rollers");
+      logger.info(F("Deploying the rollers"));
       rollers.deploy();
       break;
     case 'g':
-      logger.info("The current server angle is:");
+      logger.info(F("The current server angle is:"));
       logger.info(rollers.getangle());
       break;
     case 'R':
-      logger.info("Setting the roller retract position");
+      logger.info(F("Setting the roller retract position"));
       rollers.setrp(aval);
       break;
     case 'D':
-      logger.info("Setting the roller deploy position");
+      logger.info(F("Setting the roller deploy position"));
       rollers.setdp(aval);
       break;
     default:
       int value = (unsigned char)atoi(arg);
       if(value > 0 && value <= 180) // Do not include zero, as a non-number apparently converts to zero, causing bad behavior.
       {															// Typical usefull values are from 50 to 90, outside that is unlikely if assembled as per the docs.
-        logger.info("Setting the angle of the rollers to:");
+        logger.info(F("Setting the angle of the rollers to:"));
         logger.info(value);
         rollers.angle(value);
       }
       else
-        logger.info("Valid options are:\n+ up\n - down\nE enable\ne disable\nr retract\nd deploy\nR Set retract pos.\nD Set deploy pos.\nangle, an integer\n");
+        logger.info(F("Valid options are:\n+ up\n - down\nE enable\ne disable\nr retract\nd deploy\nR Set retract pos.\nD Set deploy pos.\nangle, an integer\n"));
   }
 }
 
@@ -1113,29 +2125,29 @@ void pwm_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("No pin supplied");
-        logger.info("Valid options are 7, 8, and 9");
+        logger.error(F("No pin supplied"));
+        logger.info(F("Valid options are 7, 8, and 9"));
         return;
     }
 
     int pin = atoi(arg);
 
     if(pin < 7 || pin > 9) {
-        logger.error("Hey... That's not a PWM pin!");
+        logger.error(F("Hey... That's not a PWM pin!"));
         return;
     }
 
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("No PWM value supplied");
+        logger.error(F("No PWM value supplied"));
         return;
     }
 
     int value = atoi(arg);
 
     if(value < 0 || value > 255) {
-        logger.error("Value out of range (0:255)");
+        logger.error(F("Value out of range (0:255)"));
     }
 
     analogWrite(pin, value);
@@ -1147,7 +2159,7 @@ void sweep_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("Missing width");
+        logger.error(F("Missing width"));
         return;
     }
 
@@ -1156,7 +2168,7 @@ void sweep_command(void) {
     arg = serial_command.next();
 
     if(!arg) {
-        logger.error("Missing height");
+        logger.error(F("Missing height"));
         return;
     }
 
@@ -1173,15 +2185,15 @@ void sweep(long width, long height) {
     unsigned int passes =  ceil(height / pass_width);
     unsigned int delta_y = floor(height / passes);
 
-    logger.info("Sweeping.");
-    logger.info() << "   Coverage per pass: " << pass_width << Comms::endl;
-    logger.info() << "   Total Width: " << width << Comms::endl;
-    logger.info() << "   Total Height: " << height << Comms::endl;
-    logger.info() << "   Passes: " << passes << ", Delta Y: " << delta_y
+    logger.info(F("Sweeping."));
+    logger.info() << F("   Coverage per pass: ") << pass_width << Comms::endl;
+    logger.info() << F("   Total Width: ") << width << Comms::endl;
+    logger.info() << F("   Total Height: ") << height << Comms::endl;
+    logger.info() << F("   Passes: ") << passes << F(", Delta Y: ") << delta_y
             << Comms::endl;
 
-    for(int pass = 0; pass < passes; pass++) {
-        logger.info() << "   Pass: " << pass + 1 << " of " << passes << Comms::endl;
+    for(unsigned int pass = 0; pass < passes; pass++) {
+        logger.info() << F("   Pass: ") << pass + 1 << F(" of ") << passes << Comms::endl;
 
         // 1. Lower rollers
         rollers.deploy();
@@ -1218,7 +2230,7 @@ void absolute_move(void) {
     arg = serial_command.next();
 
     if(arg == NULL) {
-        logger.error("Missing x position (double)");
+        logger.error(F("Missing x position (double)"));
         return;
     }
 
@@ -1227,14 +2239,14 @@ void absolute_move(void) {
     arg = serial_command.next();
 
     if(arg == NULL) {
-        logger.error("Missing y position (double)");
+        logger.error(F("Missing y position (double)"));
         return;
     }
 
     double y_position = atof(arg);
 
     if(x_position < 0 || y_position < 0) {
-        logger.error("Absolute positions must be positive.");
+        logger.error(F("Absolute positions must be positive."));
         return;
     }
 
@@ -1248,7 +2260,7 @@ void incremental_move(void) {
     arg = serial_command.next();
 
     if(arg == NULL) {
-        logger.error("Missing x position (double)");
+        logger.error(F("Missing x position (double)"));
         return;
     }
 
@@ -1257,7 +2269,7 @@ void incremental_move(void) {
     arg = serial_command.next();
 
     if(arg == NULL) {
-        logger.error("Missing y position (double)");
+        logger.error(F("Missing y position (double)"));
         return;
     }
 
@@ -1282,7 +2294,7 @@ void wait_command(void) {
 void primitive_voltage_command(void) {
     double voltage = primitive_voltage();
 
-    logger.info() << "Primitive Voltage: " << voltage << " volts."
+    logger.info() << F("Primitive Voltage: ") << voltage << F(" volts.")
         << Comms::endl;
 }
 
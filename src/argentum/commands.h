@@ -74,8 +74,15 @@ void pause_command(void);
 void resume_command(void);
 void fire_command(void);
 void draw_command(void);
+void fly_command(void);
+void pulse_command(void);
 void print_command(void);
 void print_ram(void);
+void mem_command(void);
+void prof_command(void);
+void jitter_command(void);
+void trace_command(void);
+void nozzles_command(void);
 
 void help_command(void);
 void version_command(void);
@@ -86,12 +93,24 @@ void unknown_command(const char *cmd);
 
 // SD
 void init_sd_command(void);
+void sdcache_command(void);
 void ls_command(void);
 void rm_command(void);
 void md5_command(void);
 void djb2_command(void);
+void crc32_command(void);
 void recv_command(void);
 void echo_command(void);
+void sdbench_command(void);
+
+// Cycle counts of the hot paths. Only make cycles builds them in.
+#ifndef CYCLES
+#define CYCLES 0
+#endif
+
+#if CYCLES
+void cycles_command(void);
+#endif
 
 // GPIO
 void analog_command(void);
@@ -106,6 +125,13 @@ void limit_switch_command(void);
 
 void primitive_voltage_command(void);
 
+// Fire-on-the-fly print playback
+void fly_move(const char axis, long steps);
+void fly_fire(char *spec);
+void fly_drain(void);
+void fly_run(void);
+void fly_update_speed_limit(void);
+
 
 
 #endif
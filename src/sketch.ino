@@ -7,6 +7,15 @@
 #include "util/utils.h"
 #include "util/axis.h"
 #include "util/logging.h"
+#include "util/firing.h"
+#include "util/nozzles.h"
+#include "util/blockio.h"
+#include "util/arena.h"
+#include "util/sdcard.h"
+#include "util/catalogue.h"
+#include "util/hal.h"
+#include "util/profile.h"
+#include "util/telemetry.h"
 #include "argentum/argentum.h"
 
 #include "argentum/boardtests.h"
@@ -14,11 +23,15 @@
 #include "util/SdFat/SdFat.h"
 
 SdFile myFile;
+BlockReader reader;
+
+// Defined further down. The IDE generates prototypes, other builds don't.
+void sle_command(void);
 
 void setup() {
     comms.initialise();
 
-    logger.minimum_log_level = Logger::Info;
+    logger.minimum_log_level = LOG_LEVEL;
     logger.enabled = true;
 
     colour_init();
@@ -32,91 +45,105 @@ void setup() {
     settings_initialise();
 
     cartridge_initialise();
+    nozzles_initialise();
     analog_initialise();
     limit_initialise();
     fet_initialise();
 
     // Calibration
-    serial_command.addCommand("c", &calibrate_command);
-    serial_command.addCommand("calibrate", &calibrate_command);
-    //serial_command.addCommand("cl", &calibrate_loop_command);
+    serial_command.addCommand(F("c"), &calibrate_command);
+    serial_command.addCommand(F("calibrate"), &calibrate_command);
+    //serial_command.addCommand(F("cl"), &calibrate_loop_command);
 
     // Movement
-    serial_command.addCommand("m", &move_command);
-    serial_command.addCommand("M", &move_command);
+    serial_command.addCommand(F("m"), &move_command);
+    serial_command.addCommand(F("M"), &move_command);
 
-    serial_command.addCommand("0", &goto_zero_command);
-    serial_command.addCommand(")", &zero_position_command);
-    serial_command.addCommand("home", &home_command);
-    serial_command.addCommand("pos", &current_position_command);
+    serial_command.addCommand(F("0"), &goto_zero_command);
+    serial_command.addCommand(F(")"), &zero_position_command);
+    serial_command.addCommand(F("home"), &home_command);
+    serial_command.addCommand(F("pos"), &current_position_command);
 
 
     // Motor
-    serial_command.addCommand("x", &power_command);
-    serial_command.addCommand("stest", &stest_command);
-    serial_command.addCommand("s", &speed_command);
-    serial_command.addCommand("a", &acceleration_command);
+    serial_command.addCommand(F("x"), &power_command);
+    serial_command.addCommand(F("stest"), &stest_command);
+    serial_command.addCommand(F("s"), &speed_command);
+    serial_command.addCommand(F("a"), &acceleration_command);
 
-    serial_command.addCommand("+", &motors_on_command);
-    //serial_command.addCommand("=", &motors_on_command);
-    serial_command.addCommand("-", &motors_off_command);
-    //serial_command.addCommand("_", &motors_off_command);
+    serial_command.addCommand(F("+"), &motors_on_command);
+    //serial_command.addCommand(F("="), &motors_on_command);
+    serial_command.addCommand(F("-"), &motors_off_command);
+    //serial_command.addCommand(F("_"), &motors_off_command);
 
     // Roller Servo
-    serial_command.addCommand("l", &rollers_command);
+    serial_command.addCommand(F("l"), &rollers_command);
 
     // Print
-    serial_command.addCommand("p", &print_command);
-    serial_command.addCommand("P", &pause_command);
-    serial_command.addCommand("R", &resume_command);
-    serial_command.addCommand("F", &fire_command);
-    serial_command.addCommand("D", &draw_command);
+    serial_command.addCommand(F("p"), &print_command);
+    serial_command.addCommand(F("P"), &pause_command);
+    serial_command.addCommand(F("R"), &resume_command);
+    serial_command.addCommand(F("F"), &fire_command);
+    serial_command.addCommand(F("D"), &draw_command);
+    serial_command.addCommand(F("fly"), &fly_command);
+    serial_command.addCommand(F("pulse"), &pulse_command);
+    serial_command.addCommand(F("nozzles"), &nozzles_command);
 
     // Settings
-    serial_command.addCommand("?", &read_setting_command);
-    serial_command.addCommand("?eeprom", &read_saved_setting_command);
-    serial_command.addCommand("!write", &write_setting_command);
+    serial_command.addCommand(F("?"), &read_setting_command);
+    serial_command.addCommand(F("?eeprom"), &read_saved_setting_command);
+    serial_command.addCommand(F("!write"), &write_setting_command);
 
     // Experimentals
-    //serial_command.addCommand("@", &acc);
-    serial_command.addCommand("lim", &limit_switch_command);
-    serial_command.addCommand("ram", &print_ram);
+    //serial_command.addCommand(F("@"), &acc);
+    serial_command.addCommand(F("lim"), &limit_switch_command);
+    serial_command.addCommand(F("ram"), &print_ram);
+    serial_command.addCommand(F("mem"), &mem_command);
+    serial_command.addCommand(F("prof"), &prof_command);
+    serial_command.addCommand(F("jitter"), &jitter_command);
+    serial_command.addCommand(F("trace"), &trace_command);
 
-    //serial_command.addCommand("digital", &digital_command);
-    //serial_command.addCommand("analog", &analog_command);
+    //serial_command.addCommand(F("digital"), &digital_command);
+    //serial_command.addCommand(F("analog"), &analog_command);
 
     // SD Card
-    serial_command.addCommand("ls", &ls_command);
-    serial_command.addCommand("rm", &rm_command);
-    serial_command.addCommand("md5", &md5_command);
-    serial_command.addCommand("djb2", &djb2_command);
-    serial_command.addCommand("sd", &init_sd_command);
-    serial_command.addCommand("recv", &recv_command);
-    serial_command.addCommand("echo", &echo_command);
+    serial_command.addCommand(F("ls"), &ls_command);
+    serial_command.addCommand(F("rm"), &rm_command);
+    serial_command.addCommand(F("md5"), &md5_command);
+    serial_command.addCommand(F("djb2"), &djb2_command);
+    serial_command.addCommand(F("crc32"), &crc32_command);
+    serial_command.addCommand(F("sd"), &init_sd_command);
+    serial_command.addCommand(F("sdcache"), &sdcache_command);
+    serial_command.addCommand(F("recv"), &recv_command);
+    serial_command.addCommand(F("echo"), &echo_command);
+    serial_command.addCommand(F("sdbench"), &sdbench_command);
+#if CYCLES
+    serial_command.addCommand(F("cycles"), &cycles_command);
+#endif
 
     // Colour
-    serial_command.addCommand("red", &red_command);
-    serial_command.addCommand("green", &green_command);
-    serial_command.addCommand("blue", &blue_command);
+    serial_command.addCommand(F("red"), &red_command);
+    serial_command.addCommand(F("green"), &green_command);
+    serial_command.addCommand(F("blue"), &blue_command);
 
-    serial_command.addCommand("pwm", &pwm_command);
+    serial_command.addCommand(F("pwm"), &pwm_command);
 
-    serial_command.addCommand("sweep", &sweep_command);
+    serial_command.addCommand(F("sweep"), &sweep_command);
 
-    serial_command.addCommand("abs", &absolute_move);
-    serial_command.addCommand("inc", &incremental_move);
+    serial_command.addCommand(F("abs"), &absolute_move);
+    serial_command.addCommand(F("inc"), &incremental_move);
 
-    serial_command.addCommand("++", &plus_command);
-    serial_command.addCommand("--", &minus_command);
-    serial_command.addCommand("wait", &wait_command);
+    serial_command.addCommand(F("++"), &plus_command);
+    serial_command.addCommand(F("--"), &minus_command);
+    serial_command.addCommand(F("wait"), &wait_command);
 
-    serial_command.addCommand("volt", &primitive_voltage_command);
+    serial_command.addCommand(F("volt"), &primitive_voltage_command);
 
     // Common
-    serial_command.addCommand("help", &help_command);
-    serial_command.addCommand("version", &version_command);
-    serial_command.addCommand("pnum", &printer_number_command);
-    serial_command.addCommand("sle", &sle_command);
+    serial_command.addCommand(F("help"), &help_command);
+    serial_command.addCommand(F("version"), &version_command);
+    serial_command.addCommand(F("pnum"), &printer_number_command);
+    serial_command.addCommand(F("sle"), &sle_command);
 
     serial_command.setDefaultHandler(&unknown_command);
 
@@ -148,25 +175,38 @@ void setup() {
     x_axis.length = global_settings.calibration.x_axis.length;
     y_axis.length = global_settings.calibration.y_axis.length;
 
+    // Print columns run along Y, so that is where firings are queued
+    y_axis.set_firing_queue(&firing_queue);
+    fly_update_speed_limit();
+
     //uint8_t *firing_buffer = (uint8_t*)malloc(4096);
     printer_number_command();
     version_command();
     analogWrite(8, 255);
-}
 
-static int white = 0;
-static long old_time = 0;
-static bool dir = false;
+#if CYCLES && defined(CYCLES_AT_BOOT)
+    // make cycles: report and stop, for running under simavr
+    cycles_command();
+    Serial.flush();
+    hal_halt();
+#endif
+}
 
 // Note: This loop _should_ execute three times faster than the motors can step
-// at 5000 speed. Measured.
+// at 5000 speed. Measured; prof shows the loop time as it is now.
 void loop() {
+    profile_loop();
+
     x_axis.run();
     y_axis.run();
 
     //run_tests();
 
-    /*if(millis() - old_time > 10) {
+    /*static int white = 0;
+    static long old_time = 0;
+    static bool dir = false;
+
+    if(millis() - old_time > 10) {
         if(!dir) {
             white++;
         } else {
@@ -197,11 +237,11 @@ void serialEvent(void) {
     if (simulateLocalEcho)
     {
         if(input == 0x08) {
-            Serial.print("\x08 ");
+            Serial.print(F("\x08 "));
         }
 
         if(input == '\r') {
-            Serial.print("\r\n");
+            Serial.print(F("\r\n"));
         } else {
             Serial.print((char)input);
         }
@@ -211,11 +251,10 @@ void serialEvent(void) {
 }
 
 void parse_command(byte* command) {
-    int dist = 0;
-
     switch(command[0]) {
         case 0x01:
             fire_head((byte)command[1], (byte)command[2], (byte)command[5], (byte)command[6]);
+            nozzles_flush_if_needed();
 
             break;
 
@@ -225,6 +264,7 @@ void parse_command(byte* command) {
 }
 
 extern void fire_spec(char *spec);
+extern bool fly_enabled;
 
 bool readFile(char *filename) {
     byte command[20];
@@ -242,7 +282,7 @@ bool readFile(char *filename) {
 
     // Check if file open succeeded, if not output error message
     if (!myFile.isOpen()) {
-        Serial.print("File could not be opened: ");
+        Serial.print(F("File could not be opened: "));
         Serial.println(filename);
 
         return false;
@@ -250,13 +290,31 @@ bool readFile(char *filename) {
 
     //Serial.println("Starting");
     //Serial.println(start);
-    logger.info() << "readFile(" << filename << ")" << Comms::endl;
+    logger.info() << F("readFile(") << filename << F(")") << Comms::endl;
+
+    // Playback streams the file with multi-block reads. Commands run during
+    // the print check out arena space above this.
+    ArenaBuffer stream_buffer(BLOCK_SIZE);
+
+    if(!reader.open(sd.vol(), &myFile, stream_buffer.data)) {
+        Serial.print(F("File could not be read: "));
+        Serial.println(filename);
 
-    long start = micros();
+        myFile.close();
+
+        return false;
+    }
+
+    sdcard_reset_cache_stats();
+    x_axis.reset_jitter();
+    y_axis.reset_jitter();
+    telemetry_start();
+
+    /*long start = micros();
     long end = 0L;
     long count = 0L;
 
-    /*uint8_t buffer[4096];
+    uint8_t buffer[4096];
 
     while(myFile.available()) {
         count++;
@@ -271,7 +329,7 @@ bool readFile(char *filename) {
     double time = end - start;
     double average = time / count;
 
-    Serial.println("Timing:");
+    Serial.println(F("Timing:"));
     Serial.println(start);
     Serial.println(end);
     Serial.println(time);
@@ -282,6 +340,8 @@ bool readFile(char *filename) {
 
     colour(COLOUR_PRINTING);
 
+    long min_x = 0;
+    long min_y = 0;
     long max_x = 0;
     long max_y = 0;
 
@@ -289,9 +349,14 @@ bool readFile(char *filename) {
     long cur_y = 0;
 
     // loop through file
-    while(myFile.available()) {
+    while(reader.available()) {
+        // Keep the head moving while queued firings are read ahead
+        fly_run();
+
+        uint16_t parse_start = profile_begin();
+
         // read in first byte of command
-        command[0] = myFile.read();
+        command[0] = reader.read();
 
         //Serial.println(command[0]);
 
@@ -300,7 +365,7 @@ bool readFile(char *filename) {
             switch(command[0]) {
                 case 1:
                     for(int i = 0; i < 7; i++) {
-                        command[i + 1] = myFile.read();
+                        command[i + 1] = reader.read();
                     }
 
                     break;
@@ -311,27 +376,40 @@ bool readFile(char *filename) {
             // Textual version of firing commands
             int i = 1;
 
-            while(myFile.peek() != '\n' && i < 18) {
-                command[i] = myFile.read();
+            while(reader.peek() != '\n' && i < 18) {
+                command[i] = reader.read();
                 i++;
             }
             command[i] = 0x00;
 
-            fire_spec((char*)command + 2);
+            if(reader.peek() == '\n') {
+                reader.read();
+            }
+
+            profile_end(PROFILE_PARSE, parse_start);
+
+            fly_fire((char*)command + 2);
         } else if(command[0] == 'M') {
             // read in extra bytes if necessary
             int i = 1;
 
-            while(myFile.peek() != '\n' && i < 18) {
-                command[i] = myFile.read();
+            while(reader.peek() != '\n' && i < 18) {
+                command[i] = reader.read();
                 i++;
             }
             command[i] = 0x00;
 
+            if(reader.peek() == '\n') {
+                reader.read();
+            }
+
             long steps = atol((const char *)&command[4]);
             char axis = command[2];
 
-            //logger.info() << "Movement command: " << axis << " " << steps << Comms::endl;
+            profile_end(PROFILE_PARSE, parse_start);
+
+            logger.debug() << F("Movement command: ") << axis << F(" ") << steps
+                    << Comms::endl;
 
             if(axis == 'X') {
                 cur_x += steps;
@@ -340,11 +418,15 @@ bool readFile(char *filename) {
                     cur_x = 0;
                 }
 
+                if(cur_x < min_x) {
+                    min_x = cur_x;
+                }
+
                 if(cur_x > max_x) {
                     max_x = cur_x;
                 }
 
-                Serial.println(".");
+                Serial.println(F("."));
             }
 
             if(axis == 'Y') {
@@ -354,33 +436,55 @@ bool readFile(char *filename) {
                     cur_y = 0;
                 }
 
+                if(cur_y < min_y) {
+                    min_y = cur_y;
+                }
+
                 if(cur_y > max_y) {
                     max_y = cur_y;
                 }
 
-                //logger.info() << "steps: " << steps << " cur_y: " << cur_y
-                //        << " max_y: " << max_y << Comms::endl;
+                logger.debug() << F("steps: ") << steps << F(" cur_y: ") << cur_y
+                        << F(" max_y: ") << max_y << Comms::endl;
             }
 
-            for(int i = 0; i < 10; i++) {
-                serial_command.add_byte(command[i]);
+            if(fly_enabled && (axis == 'X' || axis == 'Y')) {
+                fly_move(axis, steps);
+            } else {
+                fly_drain();
 
-                if(command[i] == '\n') {
-                    break;
+                for(int i = 0; i < 10; i++) {
+                    serial_command.add_byte(command[i]);
+
+                    if(command[i] == '\n') {
+                        break;
+                    }
                 }
+
+                serial_command.add_byte('\n');
             }
         } else {
+            // Anything else runs once its line is complete, after the head
+            // has caught up with the queued firings.
+            if(command[0] == '\n' || command[0] == '\r') {
+                fly_drain();
+            }
+
             serial_command.add_byte(command[0]);
         }
 
         //Check if Any serial commands have been received
         if(Serial.available()) {
             if(Serial.peek() == 'S') {
+                reader.close();
                 myFile.close();
 
+                firing_queue.clear();
+                y_axis.hold();
+
                 //swap_motors();
 
-                Serial.println("Stopping.");
+                Serial.println(F("Stopping."));
 
                 goto_zero_command();
 
@@ -390,15 +494,28 @@ bool readFile(char *filename) {
         }
     }
 
+    fly_drain();
+
     colour(COLOUR_FINISHED);
 
-    logger.info() << "File dimensions: " << max_x << " x " << max_y << " steps"
+    logger.info() << F("File dimensions: ") << max_x << F(" x ") << max_y << F(" steps")
             << Comms::endl;
 
     x_size = max_x;
     y_size = max_y;
 
+    sdcard_print_cache_stats();
+    x_axis.print_jitter();
+    y_axis.print_jitter();
+
+    telemetry_report(filename, myFile.fileSize(),
+            x_axis.jitter.late_steps + y_axis.jitter.late_steps);
+
     //close file
+    reader.close();
+
+    catalogue_printed(sd.vwd(), &myFile, min_x, min_y, max_x, max_y);
+
     myFile.close();
 
     //swap_motors();
@@ -71,12 +71,12 @@ class ArduinoInStream : public ibufstream {
    * \param[in] way
    * \return true/false.
    */
-  bool seekoff(off_type off, seekdir way) {return false;}
+  bool seekoff(off_type /*off*/, seekdir /*way*/) {return false;}
  /** Internal - do not use.
   * \param[in] pos
   * \return true/false.
   */
-  bool seekpos(pos_type pos) {return false;}
+  bool seekpos(pos_type /*pos*/) {return false;}
 
  private:
   char *m_line;
@@ -107,8 +107,8 @@ class ArduinoOutStream : public ostream {
     m_pr->write(c);
   }
   void putstr(const char* str) {m_pr->write(str);}
-  bool seekoff(off_type off, seekdir way) {return false;}
-  bool seekpos(pos_type pos) {return false;}
+  bool seekoff(off_type /*off*/, seekdir /*way*/) {return false;}
+  bool seekpos(pos_type /*pos*/) {return false;}
   bool sync() {return true;}
   pos_type tellpos() {return 0;}
   /// @endcond
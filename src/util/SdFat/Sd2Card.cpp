@@ -19,6 +19,8 @@
  */
 #include <Sd2Card.h>
 #include <SdSpi.h>
+#include "../profile.h"
+#include "../trace.h"
 // debug trace macro
 #define SD_TRACE(m, b)
 // #define SD_TRACE(m, b) Serial.print(m);Serial.println(b);
@@ -332,6 +334,17 @@ bool Sd2Card::begin(uint8_t chipSelectPin, uint8_t sckDivisor) {
   return false;
 }
 //------------------------------------------------------------------------------
+/** Check for busy.  MISO low indicates the card is busy.
+ *
+ * \return true if busy else false.
+ */
+bool Sd2Card::isBusy() {
+  chipSelectLow();
+  bool rtn = m_spi.receive() != 0XFF;
+  chipSelectHigh();
+  return rtn;
+}
+//------------------------------------------------------------------------------
 /**
  * Read a 512 byte block from an SD card.
  *
@@ -343,13 +356,18 @@ bool Sd2Card::begin(uint8_t chipSelectPin, uint8_t sckDivisor) {
  */
 bool Sd2Card::readBlock(uint32_t blockNumber, uint8_t* dst) {
   SD_TRACE("RB", blockNumber);
+  trace(TRACE_SD_READ, blockNumber >> 16, blockNumber);
+  uint16_t start = profile_begin();
+  bool ok;
   // use address if not SDHC card
   if (type()!= SD_CARD_TYPE_SDHC) blockNumber <<= 9;
   if (cardCommand(CMD17, blockNumber)) {
     error(SD_CARD_ERROR_CMD17);
     goto fail;
   }
-  return readData(dst, 512);
+  ok = readData(dst, 512);
+  profile_end(PROFILE_SD_READ, start);
+  return ok;
 
  fail:
   chipSelectHigh();
@@ -364,8 +382,11 @@ bool Sd2Card::readBlock(uint32_t blockNumber, uint8_t* dst) {
  * the value zero, false, is returned for failure.
  */
 bool Sd2Card::readData(uint8_t *dst) {
+  uint16_t start = profile_begin();
   chipSelectLow();
-  return readData(dst, 512);
+  bool ok = readData(dst, 512);
+  profile_end(PROFILE_SD_READ, start);
+  return ok;
 }
 //------------------------------------------------------------------------------
 bool Sd2Card::readData(uint8_t* dst, size_t count) {
@@ -437,6 +458,7 @@ bool Sd2Card::readRegister(uint8_t cmd, void* buf) {
  */
 bool Sd2Card::readStart(uint32_t blockNumber) {
   SD_TRACE("RS", blockNumber);
+  trace(TRACE_SD_READ, blockNumber >> 16, blockNumber);
   if (type()!= SD_CARD_TYPE_SDHC) blockNumber <<= 9;
   if (cardCommand(CMD18, blockNumber)) {
     error(SD_CARD_ERROR_CMD18);
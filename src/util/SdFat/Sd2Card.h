@@ -156,6 +156,7 @@ class Sd2Card {
             uint8_t chipSelectPin = SD_CHIP_SELECT_PIN) {
     return begin(chipSelectPin, sckDivisor);
   }
+  bool isBusy();
   bool readBlock(uint32_t block, uint8_t* dst);
   /**
    * Read a card's CID register. The CID contains card identification
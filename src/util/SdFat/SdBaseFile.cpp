@@ -1345,7 +1345,7 @@ int SdBaseFile::read(void* buf, size_t nbyte) {
       }
       block = m_vol->clusterStartBlock(m_curCluster) + blockOfCluster;
     }
-    if (offset != 0 || toRead < 512 || block == m_vol->cacheBlockNumber()) {
+    if (offset != 0 || toRead < 512 || m_vol->cacheHolds(block)) {
       // amount to be read from current block
       n = 512 - offset;
       if (n > toRead) n = toRead;
@@ -1371,8 +1371,7 @@ int SdBaseFile::read(void* buf, size_t nbyte) {
         if (mb < nb) nb = mb;
       }
       n = 512*nb;
-      if (m_vol->cacheBlockNumber() <= block
-        && block < (m_vol->cacheBlockNumber() + nb)) {
+      if (m_vol->cacheHolds(block, nb)) {
         // flush cache if a block is in the cache
         if (!m_vol->cacheSync()) {
           DBG_FAIL_MACRO;
@@ -2201,9 +2200,7 @@ int SdBaseFile::write(const void* buf, size_t nbyte) {
     } else if (!USE_MULTI_BLOCK_SD_IO || nToWrite < 1024) {
       // use single block write command
       n = 512;
-      if (m_vol->cacheBlockNumber() == block) {
-        m_vol->cacheInvalidate();
-      }
+      m_vol->cacheInvalidateBlock(block);
       if (!m_vol->writeBlock(block, src)) {
         DBG_FAIL_MACRO;
         goto fail;
@@ -2221,9 +2218,7 @@ int SdBaseFile::write(const void* buf, size_t nbyte) {
       }
       for (uint8_t b = 0; b < nBlock; b++) {
         // invalidate cache if block is in cache
-        if ((block + b) == m_vol->cacheBlockNumber()) {
-          m_vol->cacheInvalidate();
-        }
+        m_vol->cacheInvalidateBlock(block + b);
         if (!m_vol->sdCard()->writeData(src + 512*b)) {
           DBG_FAIL_MACRO;
           goto fail;
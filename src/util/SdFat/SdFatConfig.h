@@ -36,6 +36,17 @@
 #define USE_SEPARATE_FAT_CACHE 0
 #endif  // __arm__
 //------------------------------------------------------------------------------
+/**
+ * Number of 512 byte blocks in the volume cache when USE_SEPARATE_FAT_CACHE
+ * is zero.  Data, directory and FAT blocks share them and the least recently
+ * used block is replaced first, so walking a cluster chain no longer throws
+ * out the data block being read.  One block gives the original single
+ * buffer cache.  Each block costs 518 bytes of SRAM.
+ */
+#ifndef SD_CACHE_BLOCKS
+#define SD_CACHE_BLOCKS 2
+#endif  // SD_CACHE_BLOCKS
+//------------------------------------------------------------------------------
 /**
  * Set USE_MULTI_BLOCK_SD_IO nonzero to use multi-block SD read/write.
  *
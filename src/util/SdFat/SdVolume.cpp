@@ -23,16 +23,22 @@
 // raw block cache
 uint8_t  SdVolume::m_fatCount;          // number of FATs on volume
 uint32_t SdVolume::m_blocksPerFat;      // FAT size in blocks
+#if USE_SEPARATE_FAT_CACHE
 cache_t  SdVolume::m_cacheBuffer;       // 512 byte cache for Sd2Card
 uint32_t SdVolume::m_cacheBlockNumber;  // current block number
 uint8_t  SdVolume::m_cacheStatus;       // status of cache block
-#if USE_SEPARATE_FAT_CACHE
 cache_t  SdVolume::m_cacheFatBuffer;       // 512 byte cache for FAT
 uint32_t SdVolume::m_cacheFatBlockNumber;  // current Fat block number
 uint8_t  SdVolume::m_cacheFatStatus;       // status of cache Fatblock
+#else  // USE_SEPARATE_FAT_CACHE
+cache_t  SdVolume::m_cacheBuffer[SD_CACHE_BLOCKS];       // block cache
+uint32_t SdVolume::m_cacheBlockNumber[SD_CACHE_BLOCKS];  // block numbers
+uint8_t  SdVolume::m_cacheStatus[SD_CACHE_BLOCKS];       // block status
+uint8_t  SdVolume::m_cacheOrder[SD_CACHE_BLOCKS];        // LRU order
 #endif  // USE_SEPARATE_FAT_CACHE
 Sd2Card* SdVolume::m_sdCard;            // pointer to SD card object
 #endif  // USE_MULTIPLE_CARDS
+SdVolume::CacheStats SdVolume::cacheStats;
 //------------------------------------------------------------------------------
 // find a contiguous group of clusters
 bool SdVolume::allocContiguous(uint32_t count, uint32_t* curCluster) {
@@ -129,7 +135,10 @@ cache_t* SdVolume::cacheFetch(uint32_t blockNumber, uint8_t options) {
 }
 //------------------------------------------------------------------------------
 cache_t* SdVolume::cacheFetchData(uint32_t blockNumber, uint8_t options) {
-  if (m_cacheBlockNumber != blockNumber) {
+  if (m_cacheBlockNumber == blockNumber) {
+    cacheStats.hits++;
+  } else {
+    cacheStats.misses++;
     if (!cacheWriteData()) {
       DBG_FAIL_MACRO;
       goto fail;
@@ -151,7 +160,10 @@ cache_t* SdVolume::cacheFetchData(uint32_t blockNumber, uint8_t options) {
 }
 //------------------------------------------------------------------------------
 cache_t* SdVolume::cacheFetchFat(uint32_t blockNumber, uint8_t options) {
-  if (m_cacheFatBlockNumber != blockNumber) {
+  if (m_cacheFatBlockNumber == blockNumber) {
+    cacheStats.fatHits++;
+  } else {
+    cacheStats.fatMisses++;
     if (!cacheWriteFat()) {
       DBG_FAIL_MACRO;
       goto fail;
@@ -211,25 +223,65 @@ bool SdVolume::cacheWriteFat() {
  fail:
   return false;
 }
+//------------------------------------------------------------------------------
+bool SdVolume::cacheHolds(uint32_t blockNumber, uint8_t count) {
+  return m_cacheBlockNumber >= blockNumber
+    && m_cacheBlockNumber - blockNumber < count;
+}
+//------------------------------------------------------------------------------
+void SdVolume::cacheInvalidate() {
+    m_cacheBlockNumber = 0XFFFFFFFF;
+    m_cacheStatus = 0;
+}
+//------------------------------------------------------------------------------
+void SdVolume::cacheInvalidateBlock(uint32_t blockNumber) {
+  if (m_cacheBlockNumber == blockNumber) cacheInvalidate();
+}
 #else  // USE_SEPARATE_FAT_CACHE
 //------------------------------------------------------------------------------
 cache_t* SdVolume::cacheFetch(uint32_t blockNumber, uint8_t options) {
-  if (m_cacheBlockNumber != blockNumber) {
-    if (!cacheSync()) {
+  uint8_t i;
+  uint8_t slot;
+  bool fat = options & CACHE_STATUS_FAT_BLOCK;
+
+  for (i = 0; i < SD_CACHE_BLOCKS; i++) {
+    if (m_cacheBlockNumber[m_cacheOrder[i]] == blockNumber) break;
+  }
+  if (i < SD_CACHE_BLOCKS) {
+    slot = m_cacheOrder[i];
+    if (fat) {
+      cacheStats.fatHits++;
+    } else {
+      cacheStats.hits++;
+    }
+  } else {
+    // replace the least recently used block
+    i = SD_CACHE_BLOCKS - 1;
+    slot = m_cacheOrder[i];
+    if (fat) {
+      cacheStats.fatMisses++;
+    } else {
+      cacheStats.misses++;
+    }
+    if (!cacheWriteSlot(slot)) {
       DBG_FAIL_MACRO;
       goto fail;
     }
+    m_cacheStatus[slot] = 0;
+    m_cacheBlockNumber[slot] = 0XFFFFFFFF;
     if (!(options & CACHE_OPTION_NO_READ)) {
-      if (!m_sdCard->readBlock(blockNumber, m_cacheBuffer.data)) {
+      if (!m_sdCard->readBlock(blockNumber, m_cacheBuffer[slot].data)) {
         DBG_FAIL_MACRO;
         goto fail;
       }
     }
-    m_cacheStatus = 0;
-    m_cacheBlockNumber = blockNumber;
+    m_cacheBlockNumber[slot] = blockNumber;
   }
-  m_cacheStatus |= options & CACHE_STATUS_MASK;
-  return &m_cacheBuffer;
+  // move to the front
+  for (; i > 0; i--) m_cacheOrder[i] = m_cacheOrder[i - 1];
+  m_cacheOrder[0] = slot;
+  m_cacheStatus[slot] |= options & CACHE_STATUS_MASK;
+  return &m_cacheBuffer[slot];
 
  fail:
   return 0;
@@ -239,21 +291,37 @@ cache_t* SdVolume::cacheFetchFat(uint32_t blockNumber, uint8_t options) {
   return cacheFetch(blockNumber, options | CACHE_STATUS_FAT_BLOCK);
 }
 //------------------------------------------------------------------------------
+bool SdVolume::cacheHolds(uint32_t blockNumber, uint8_t count) {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    if (m_cacheBlockNumber[i] >= blockNumber
+      && m_cacheBlockNumber[i] - blockNumber < count) return true;
+  }
+  return false;
+}
+//------------------------------------------------------------------------------
 bool SdVolume::cacheSync() {
-  if (m_cacheStatus & CACHE_STATUS_DIRTY) {
-    if (!m_sdCard->writeBlock(m_cacheBlockNumber, m_cacheBuffer.data)) {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    if (!cacheWriteSlot(i)) return false;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+bool SdVolume::cacheWriteSlot(uint8_t slot) {
+  if (m_cacheStatus[slot] & CACHE_STATUS_DIRTY) {
+    uint32_t lbn = m_cacheBlockNumber[slot];
+    if (!m_sdCard->writeBlock(lbn, m_cacheBuffer[slot].data)) {
       DBG_FAIL_MACRO;
       goto fail;
     }
     // mirror second FAT
-    if ((m_cacheStatus & CACHE_STATUS_FAT_BLOCK) && m_fatCount > 1) {
-      uint32_t lbn = m_cacheBlockNumber + m_blocksPerFat;
-      if (!m_sdCard->writeBlock(lbn, m_cacheBuffer.data)) {
+    if ((m_cacheStatus[slot] & CACHE_STATUS_FAT_BLOCK) && m_fatCount > 1) {
+      lbn += m_blocksPerFat;
+      if (!m_sdCard->writeBlock(lbn, m_cacheBuffer[slot].data)) {
         DBG_FAIL_MACRO;
         goto fail;
       }
     }
-    m_cacheStatus &= ~CACHE_STATUS_DIRTY;
+    m_cacheStatus[slot] &= ~CACHE_STATUS_DIRTY;
   }
   return true;
 
@@ -264,12 +332,24 @@ bool SdVolume::cacheSync() {
 bool SdVolume::cacheWriteData() {
   return cacheSync();
 }
-#endif  // USE_SEPARATE_FAT_CACHE
 //------------------------------------------------------------------------------
 void SdVolume::cacheInvalidate() {
-    m_cacheBlockNumber = 0XFFFFFFFF;
-    m_cacheStatus = 0;
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    m_cacheBlockNumber[i] = 0XFFFFFFFF;
+    m_cacheStatus[i] = 0;
+    m_cacheOrder[i] = i;
+  }
 }
+//------------------------------------------------------------------------------
+void SdVolume::cacheInvalidateBlock(uint32_t blockNumber) {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    if (m_cacheBlockNumber[i] == blockNumber) {
+      m_cacheBlockNumber[i] = 0XFFFFFFFF;
+      m_cacheStatus[i] = 0;
+    }
+  }
+}
+#endif  // USE_SEPARATE_FAT_CACHE
 //==============================================================================
 //------------------------------------------------------------------------------
 uint32_t SdVolume::clusterStartBlock(uint32_t cluster) const {
@@ -498,8 +578,7 @@ bool SdVolume::init(Sd2Card* dev, uint8_t part) {
   m_sdCard = dev;
   m_fatType = 0;
   m_allocSearchStart = 2;
-  m_cacheStatus = 0;  // cacheSync() will write block if true
-  m_cacheBlockNumber = 0XFFFFFFFF;
+  cacheInvalidate();  // cacheSync() will write blocks if dirty
 #if USE_SEPARATE_FAT_CACHE
   m_cacheFatStatus = 0;  // cacheSync() will write block if true
   m_cacheFatBlockNumber = 0XFFFFFFFF;
@@ -64,9 +64,26 @@ class SdVolume {
    */
   cache_t* cacheClear() {
     if (!cacheSync()) return 0;
+#if USE_SEPARATE_FAT_CACHE
     m_cacheBlockNumber = 0XFFFFFFFF;
     return &m_cacheBuffer;
+#else  // USE_SEPARATE_FAT_CACHE
+    cacheInvalidate();
+    return cacheAddress();
+#endif  // USE_SEPARATE_FAT_CACHE
   }
+  /** Volume cache hit and miss counts.  FAT blocks are counted apart from
+   * data and directory blocks.
+   */
+  struct CacheStats {
+    uint32_t hits;          ///< data and directory blocks found in the cache
+    uint32_t misses;        ///< data and directory blocks read from the card
+    uint32_t fatHits;       ///< FAT blocks found in the cache
+    uint32_t fatMisses;     ///< FAT blocks read from the card
+    uint32_t streamed;      ///< blocks streamed past the cache (BlockReader)
+  };
+  /** Counts since startup or the last time they were cleared. */
+  static CacheStats cacheStats;
   /** Initialize a FAT volume.  Try partition one first then try super
    * floppy format.
    *
@@ -107,6 +124,17 @@ class SdVolume {
    * \return pointer to Sd2Card object.
    */
   Sd2Card* sdCard() {return m_sdCard;}
+  /** Follow a file's cluster chain, for readers that go to the card
+   * directly rather than through SdBaseFile::read().
+   *
+   * \param[in] cluster cluster number.
+   * \param[out] next the cluster after it, or an end of chain value
+   *             greater than clusterCount() + 1.
+   * \return true for success or false for failure
+   */
+  bool nextCluster(uint32_t cluster, uint32_t* next) {
+    return fatGet(cluster, next);
+  }
 
   /** Debug access to FAT table
    *
@@ -148,10 +176,17 @@ class SdVolume {
 #if USE_MULTIPLE_CARDS
   uint8_t m_fatCount;           // number of FATs on volume
   uint32_t m_blocksPerFat;      // FAT size in blocks
+#if USE_SEPARATE_FAT_CACHE
   cache_t m_cacheBuffer;        // 512 byte cache for device blocks
   uint32_t m_cacheBlockNumber;  // Logical number of block in the cache
-  Sd2Card* m_sdCard;            // Sd2Card object for cache
   uint8_t m_cacheStatus;        // status of cache block
+#else  // USE_SEPARATE_FAT_CACHE
+  cache_t m_cacheBuffer[SD_CACHE_BLOCKS];        // cache for device blocks
+  uint32_t m_cacheBlockNumber[SD_CACHE_BLOCKS];  // Logical block numbers
+  uint8_t m_cacheStatus[SD_CACHE_BLOCKS];        // status of cache blocks
+  uint8_t m_cacheOrder[SD_CACHE_BLOCKS];         // most recently used first
+#endif  // USE_SEPARATE_FAT_CACHE
+  Sd2Card* m_sdCard;            // Sd2Card object for cache
 #if USE_SEPARATE_FAT_CACHE
   cache_t m_cacheFatBuffer;       // 512 byte cache for FAT
   uint32_t m_cacheFatBlockNumber;  // current Fat block number
@@ -160,9 +195,16 @@ class SdVolume {
 #else  // USE_MULTIPLE_CARDS
   static uint8_t m_fatCount;            // number of FATs on volume
   static uint32_t m_blocksPerFat;       // FAT size in blocks
+#if USE_SEPARATE_FAT_CACHE
   static cache_t m_cacheBuffer;        // 512 byte cache for device blocks
   static uint32_t m_cacheBlockNumber;  // Logical number of block in the cache
   static uint8_t m_cacheStatus;        // status of cache block
+#else  // USE_SEPARATE_FAT_CACHE
+  static cache_t m_cacheBuffer[SD_CACHE_BLOCKS];        // device blocks
+  static uint32_t m_cacheBlockNumber[SD_CACHE_BLOCKS];  // Logical numbers
+  static uint8_t m_cacheStatus[SD_CACHE_BLOCKS];        // status of blocks
+  static uint8_t m_cacheOrder[SD_CACHE_BLOCKS];   // most recently used first
+#endif  // USE_SEPARATE_FAT_CACHE
 #if USE_SEPARATE_FAT_CACHE
   static cache_t m_cacheFatBuffer;       // 512 byte cache for FAT
   static uint32_t m_cacheFatBlockNumber;  // current Fat block number
@@ -171,24 +213,36 @@ class SdVolume {
   static Sd2Card* m_sdCard;            // Sd2Card object for cache
 #endif  // USE_MULTIPLE_CARDS
 
+#if USE_SEPARATE_FAT_CACHE
   cache_t *cacheAddress() {return &m_cacheBuffer;}
   uint32_t cacheBlockNumber() {return m_cacheBlockNumber;}
+#else  // USE_SEPARATE_FAT_CACHE
+  // the most recently fetched block
+  cache_t *cacheAddress() {return &m_cacheBuffer[m_cacheOrder[0]];}
+  uint32_t cacheBlockNumber() {return m_cacheBlockNumber[m_cacheOrder[0]];}
+#endif  // USE_SEPARATE_FAT_CACHE
 #if USE_MULTIPLE_CARDS
   cache_t* cacheFetch(uint32_t blockNumber, uint8_t options);
   cache_t* cacheFetchData(uint32_t blockNumber, uint8_t options);
   cache_t* cacheFetchFat(uint32_t blockNumber, uint8_t options);
+  bool cacheHolds(uint32_t blockNumber, uint8_t count = 1);
   void cacheInvalidate();
+  void cacheInvalidateBlock(uint32_t blockNumber);
   bool cacheSync();
   bool cacheWriteData();
   bool cacheWriteFat();
+  bool cacheWriteSlot(uint8_t slot);
 #else  // USE_MULTIPLE_CARDS
   static cache_t* cacheFetch(uint32_t blockNumber, uint8_t options);
   static cache_t* cacheFetchData(uint32_t blockNumber, uint8_t options);
   static cache_t* cacheFetchFat(uint32_t blockNumber, uint8_t options);
+  static bool cacheHolds(uint32_t blockNumber, uint8_t count = 1);
   static void cacheInvalidate();
+  static void cacheInvalidateBlock(uint32_t blockNumber);
   static bool cacheSync();
   static bool cacheWriteData();
   static bool cacheWriteFat();
+  static bool cacheWriteSlot(uint8_t slot);
 #endif  // USE_MULTIPLE_CARDS
 //------------------------------------------------------------------------------
   bool allocContiguous(uint32_t count, uint32_t* curCluster);
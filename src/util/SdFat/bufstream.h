@@ -61,7 +61,7 @@ class ibufstream : public istream {
   void getpos(FatPos_t *pos) {
     pos->position = m_pos;
   }
-  bool seekoff(off_type off, seekdir way) {return false;}
+  bool seekoff(off_type /*off*/, seekdir /*way*/) {return false;}
   bool seekpos(pos_type pos) {
     if (pos < m_len) {
       m_pos = pos;
@@ -125,7 +125,7 @@ class obufstream : public ostream {
   void putstr(const char *str) {
     while (*str) putch(*str++);
   }
-  bool seekoff(off_type off, seekdir way) {return false;}
+  bool seekoff(off_type /*off*/, seekdir /*way*/) {return false;}
   bool seekpos(pos_type pos) {
     if (pos > m_in) return false;
     m_in = pos;
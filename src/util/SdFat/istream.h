@@ -290,15 +290,16 @@ template <typename T>
 void istream::getNumber(T* value) {
   uint32_t tmp;
   if ((T)-1 < 0) {
-    // number is signed, max positive value
-    uint32_t const m = ((uint32_t)-1) >> (33 - sizeof(T) * 8);
+    // number is signed, max positive value, no more than 32 bits of it
+    // where long is wider (the native build)
+    uint32_t const m = ((uint32_t)-1) >> (sizeof(T) < 4 ? 33 - sizeof(T) * 8 : 1);
     // max absolute value of negative number is m + 1.
     if (getNumber(m, m + 1, &tmp)) {
       *value = (T)tmp;
     }
   } else {
-    // max unsigned value for T
-    uint32_t const m = (T)-1;
+    // max unsigned value for T, up to 32 bits
+    uint32_t const m = (uint32_t)(T)-1;
     if (getNumber(m, m, &tmp)) {
       *value = (T)tmp;
     }
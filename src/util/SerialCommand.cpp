@@ -22,6 +22,7 @@
  * along with this library.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "SerialCommand.h"
+#include "trace.h"
 
 //#define SERIALCOMMAND_DEBUG
 
@@ -41,16 +42,16 @@ SerialCommand::SerialCommand()
  * This is used for matching a found token in the buffer, and gives the pointer
  * to the handler function to deal with it.
  */
-void SerialCommand::addCommand(const char *command, void (*function)()) {
+void SerialCommand::addCommand(const __FlashStringHelper *command, void (*function)()) {
     #ifdef SERIALCOMMAND_DEBUG
-        Serial.print("Adding command (");
+        Serial.print(F("Adding command ("));
         Serial.print(commandCount);
-        Serial.print("): ");
+        Serial.print(F("): "));
         Serial.println(command);
     #endif
 
     commandList = (SerialCommandCallback *) realloc(commandList, (commandCount + 1) * sizeof(SerialCommandCallback));
-    strncpy(commandList[commandCount].command, command, SERIALCOMMAND_MAXCOMMANDLENGTH);
+    commandList[commandCount].command = (PGM_P)command;
     commandList[commandCount].function = function;
     commandCount++;
 }
@@ -78,7 +79,7 @@ void SerialCommand::add_byte(uint8_t inChar) {
 
     if (inChar == term || inChar == '\r') {     // Check for the terminator (default '\r') meaning end of command
         #ifdef SERIALCOMMAND_DEBUG
-            Serial.print("Received: ");
+            Serial.print(F("Received: "));
             Serial.println(buffer);
         #endif
 
@@ -87,19 +88,22 @@ void SerialCommand::add_byte(uint8_t inChar) {
         if (command != NULL) {
             boolean matched = false;
 
+            trace(TRACE_COMMAND, command[0],
+                    command[1] ? (command[2] << 8) | command[1] : 0);
+
             for (int i = 0; i < commandCount; i++) {
                 #ifdef SERIALCOMMAND_DEBUG
-                    Serial.print("Comparing [");
+                    Serial.print(F("Comparing ["));
                     Serial.print(command);
-                    Serial.print("] to [");
-                    Serial.print(commandList[i].command);
-                    Serial.println("]");
+                    Serial.print(F("] to ["));
+                    Serial.print((const __FlashStringHelper *)commandList[i].command);
+                    Serial.println(F("]"));
                 #endif
 
                 // Compare the found command against the list of known commands for a match
-                if (strncmp(command, commandList[i].command, SERIALCOMMAND_MAXCOMMANDLENGTH) == 0) {
+                if (strncmp_P(command, commandList[i].command, SERIALCOMMAND_MAXCOMMANDLENGTH) == 0) {
                 #ifdef SERIALCOMMAND_DEBUG
-                    Serial.print("Matched Command: ");
+                    Serial.print(F("Matched Command: "));
                     Serial.println(command);
                 #endif
 
@@ -132,7 +136,7 @@ void SerialCommand::add_byte(uint8_t inChar) {
                 buffer[bufPos] = '\0';      // Null terminate
             } else {
                 #ifdef SERIALCOMMAND_DEBUG
-                    Serial.println("Line buffer is full - increase SERIALCOMMAND_BUFFER");
+                    Serial.println(F("Line buffer is full - increase SERIALCOMMAND_BUFFER"));
                 #endif
             }
         }
@@ -149,10 +153,10 @@ void SerialCommand::clearBuffer() {
 
 void SerialCommand::installed_commands(void) {
     for(uint8_t i = 0; i < commandCount; i++) {
-        Serial.print(commandList[i].command);
+        Serial.print((const __FlashStringHelper *)commandList[i].command);
 
         if(i < commandCount - 1) {
-            Serial.print(", ");
+            Serial.print(F(", "));
         }
     }
 
@@ -164,5 +168,11 @@ void SerialCommand::installed_commands(void) {
  * Returns NULL if no more tokens exist.
  */
 char *SerialCommand::next() {
+    // Before any command has been parsed there is nothing to continue.
+    // avr-libc copes with that, glibc doesn't.
+    if (last == NULL) {
+        return NULL;
+    }
+
     return strtok_r(NULL, delim, &last);
 }
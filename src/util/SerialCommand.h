@@ -48,7 +48,7 @@ class SerialCommand {
 public:
     SerialCommand();
 
-    void addCommand(const char *command, void(*function)());
+    void addCommand(const __FlashStringHelper *command, void(*function)());
     void setDefaultHandler(void (*function)(const char *));
 
     void add_byte(uint8_t inChar);
@@ -63,7 +63,7 @@ public:
 private:
     // Data structure to hold Command/Handler function key-value pairs
     struct SerialCommandCallback {
-        char command[SERIALCOMMAND_MAXCOMMANDLENGTH + 1];
+        PGM_P command;      // in flash, F("name")
         void (*function)();
     };
 
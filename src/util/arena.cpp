@@ -0,0 +1,62 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "arena.h"
+
+#include "logging.h"
+
+static uint8_t arena[ARENA_SIZE] __attribute__((aligned(4)));
+static uint16_t top = 0;
+static uint16_t peak = 0;
+
+uint8_t * arena_checkout(uint16_t size) {
+    // Keep every checkout aligned for whatever ends up in it.
+    size = (size + 3) & ~3;
+
+    if(size > ARENA_SIZE - top) {
+        logger.error() << F("I/O arena full, ") << size << F(" bytes wanted, ")
+                << (ARENA_SIZE - top) << F(" free") << Comms::endl;
+        return NULL;
+    }
+
+    uint8_t *buffer = arena + top;
+    top += size;
+
+    if(top > peak) {
+        peak = top;
+    }
+
+    return buffer;
+}
+
+void arena_release(uint8_t *buffer) {
+    if(buffer >= arena && buffer < arena + top) {
+        top = buffer - arena;
+    }
+}
+
+uint16_t arena_used(void) {
+    return top;
+}
+
+uint16_t arena_peak(void) {
+    return peak;
+}
@@ -0,0 +1,66 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stdint.h>
+
+// One static buffer for the large transient I/O buffers of serial commands.
+// Only one command runs at a time, so instead of each of them putting a
+// kilobyte or two on the stack they check out what they need here, and
+// the RAM for it shows up once at link time. Sized for recv, the largest
+// user: a serial block with its hash and the overlap (1093, rounded up to
+// 1096) and a block of decoder output (1024). That is the peak mem reports
+// after recv in every mode; nothing else takes more than 1092. A print from
+// the card keeps its 512 byte stream block checked out throughout, and of
+// the commands that may run during one echo needs the most, 1604 in all.
+#ifndef ARENA_SIZE
+#define ARENA_SIZE 2120
+#endif
+
+// Checkouts are released last in, first out. Returns NULL if the arena
+// can't fit size more bytes.
+uint8_t * arena_checkout(uint16_t size);
+void arena_release(uint8_t *buffer);
+
+uint16_t arena_used(void);
+uint16_t arena_peak(void);
+
+// Holds a checkout for the life of a scope, so early returns give it back.
+class ArenaBuffer {
+public:
+    ArenaBuffer(uint16_t size) {
+        data = arena_checkout(size);
+        this->size = data ? size : 0;
+    }
+
+    ~ArenaBuffer() {
+        if(data) {
+            arena_release(data);
+        }
+    }
+
+    uint8_t *data;
+    uint16_t size;
+};
+
+#endif
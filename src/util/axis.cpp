@@ -21,6 +21,9 @@
 
 #include "axis.h"
 #include "logging.h"
+#include "profile.h"
+#include "telemetry.h"
+#include "trace.h"
 
 #include "../argentum/argentum.h"
 
@@ -32,6 +35,7 @@ Axis::Axis(const char axis,
     this->motor = motor;
     this->positive_limit = positive_limit;
     this->negative_limit = negative_limit;
+    this->firing_queue = NULL;
 
     length = 0;
     start_position = 0;
@@ -42,8 +46,14 @@ Axis::Axis(const char axis,
 
     direction = Axis::Positive;
 
+    max_speed = 30000;
     set_speed(1000);
     acceleration = true;
+    extending = false;
+    stepping = false;
+    ramp_speed = 0;
+
+    reset_jitter();
 
     //logger.info() << "Axis created for: " << axis << Comms::endl;
 }
@@ -59,14 +69,15 @@ bool Axis::run(void) {
     }
 
     if(current_position == desired_position) {
+        stepping = false;
         return false;
     } else {
-        //logger.info() << current_position << " -> " << desired_position
-        //        << Logger::endl;
+        logger.debug() << axis << F(" ") << current_position << F(" -> ")
+                << desired_position << Comms::endl;
 
         /*if(desired_position == Axis::PositiveLimit) {
             if(positive_limit()) {
-                logger.info("reached positive limit");
+                logger.info(F("reached positive limit"));
             } else {
                 return step();
             }
@@ -76,11 +87,13 @@ bool Axis::run(void) {
                 || ((current_position > desired_position)
                 && negative_limit())) {
             logger.warn() << axis
-                    << " tried to step in a limited direction, holding."
-                    << " current_position: " << current_position
-                    << " desired_position: " << desired_position
+                    << F(" tried to step in a limited direction, holding.")
+                    << F(" current_position: ") << current_position
+                    << F(" desired_position: ") << desired_position
                     << Comms::endl;
 
+            trace(TRACE_LIMIT, axis, current_position);
+
             hold();
 
             return false;
@@ -88,22 +101,24 @@ bool Axis::run(void) {
 
         if (acceleration)
         {
-            int acc_steps = 100;
+            uint32_t acc_steps = 100;
             uint32_t min_speed = 100;
             uint32_t d_len = abs((int32_t)desired_position - (int32_t)start_position);
-            if (d_len < acc_steps)
+            // Where an extended move ends keeps changing, so it always gets
+            // the whole ramp
+            if (d_len < acc_steps && !extending)
                 acc_steps = d_len / 2;
             uint32_t d_from_start = abs((int32_t)current_position - (int32_t)start_position);
             uint32_t d_from_end = abs((int32_t)desired_position - (int32_t)current_position);
+            uint32_t speed = desired_speed;
             if (d_from_start < acc_steps)
+                speed = min(speed, min_speed + (d_from_start + 1) * (desired_speed - min_speed) / acc_steps);
+            if (d_from_end < acc_steps)
+                speed = min(speed, min_speed + (d_from_end + 1) * (desired_speed - min_speed) / acc_steps);
+            if (speed != ramp_speed)
             {
-                int speed = min_speed + (d_from_start + 1) * (desired_speed - min_speed) / acc_steps;
-                motor->set_speed(speed);
-            }
-            else if (d_from_end < acc_steps)
-            {
-                int speed = min_speed + (d_from_end + 1) * (desired_speed - min_speed) / acc_steps;
                 motor->set_speed(speed);
+                ramp_speed = speed;
             }
         }
         else
@@ -114,10 +129,32 @@ bool Axis::run(void) {
 }
 
 bool Axis::step(void) {
+    uint16_t start = profile_begin();
     bool did_step = motor->step();
 
     if(did_step) {
-        //logger.info() << axis << " step " << current_position << Comms::endl;
+        logger.debug() << axis << F(" step ") << current_position << Comms::endl;
+
+        telemetry_step(motor->get_last_interval(), stepping);
+
+#if JITTER
+        // The first step of a move has nothing to be late against
+        if(stepping) {
+            uint32_t target = motor->get_step_delay();
+            uint32_t late = motor->get_last_interval() - target;
+
+            jitter.steps++;
+            jitter.late_total += late;
+
+            if(late > jitter.late_max) {
+                jitter.late_max = late;
+            }
+
+            if(late > target / 2) {
+                jitter.late_steps++;
+            }
+        }
+#endif
 
         if(direction == Axis::Positive) {
             current_position++;
@@ -126,10 +163,25 @@ bool Axis::step(void) {
                 current_position--;
         }
 
-        /*if(current_position == desired_position) {
-            logger.info() << axis << " axis reached goal position: "
+        // Once at the goal the next step starts another move
+        stepping = current_position != desired_position;
+
+        if(!stepping) {
+            trace(TRACE_MOVE_END, axis, current_position);
+        }
+
+#if FLY
+        if(firing_queue) {
+            firing_queue->service(current_position);
+        }
+#endif
+
+        if(current_position == desired_position) {
+            logger.debug() << axis << F(" axis reached goal position: ")
                     << desired_position << Comms::endl;
-        }*/
+        }
+
+        profile_end(PROFILE_STEP, start);
     }
 
     return did_step;
@@ -157,14 +209,14 @@ void Axis::set_direction(uint8_t direction) {
         }
     }
 
-    //logger.info() << axis << " axis setting direction to " << direction
-    //        << Comms::endl;
+    logger.debug() << axis << F(" axis setting direction to ") << direction
+            << Comms::endl;
 }
 
 void Axis::move_absolute(double position) {
     if(position < 0) {
-        logger.error() << axis << " absolute movement with negative position ("
-                << position << ")";
+        logger.error() << axis << F(" absolute movement with negative position (")
+                << position << F(")");
     }
 
     uint32_t pos = position * steps_per_mm;
@@ -177,8 +229,8 @@ void Axis::move_absolute(uint32_t position) {
         return;
     }
 
-    //logger.info() << axis << " axis absolute movement from " << current_position
-    //    << " to " << position << "" << Comms::endl;
+    logger.debug() << axis << F(" axis absolute movement from ")
+            << current_position << F(" to ") << position << Comms::endl;
 
     // Constrain the possible positions
     desired_position = max(position, 0);
@@ -186,8 +238,8 @@ void Axis::move_absolute(uint32_t position) {
     // This could really be ~14000
     desired_position = min(desired_position, 16000);
 
-    //logger.info() << axis << " axis setting new desired position to "
-    //    << desired_position << Comms::endl;
+    logger.debug() << axis << F(" axis setting new desired position to ")
+            << desired_position << Comms::endl;
 
     if(desired_position > current_position) {
         set_direction(Axis::Positive);
@@ -196,6 +248,10 @@ void Axis::move_absolute(uint32_t position) {
     }
 
     start_position = current_position;
+    extending = false;
+    ramp_speed = 0;
+
+    trace(TRACE_MOVE_START, axis, desired_position);
 }
 
 void Axis::move_incremental(double increment) {
@@ -207,12 +263,12 @@ void Axis::move_incremental(double increment) {
 void Axis::move_incremental(int32_t increment) {
     uint32_t new_desired_position = desired_position + increment;
 
-    //logger.info() << axis << " axis given increment of (" << increment
-    //        << ")" << Comms::endl;
+    logger.debug() << axis << F(" axis given increment of (") << increment
+            << F(")") << Comms::endl;
 
     if(((int32_t)desired_position + increment) < 0) {
-        logger.error() << axis << " axis given incremental move below 0.000 ("
-                << increment << ")" << Comms::endl;
+        logger.error() << axis << F(" axis given incremental move below 0.000 (")
+                << increment << F(")") << Comms::endl;
 
         new_desired_position = 0;
     }
@@ -220,6 +276,26 @@ void Axis::move_incremental(int32_t increment) {
     move_absolute(new_desired_position);
 }
 
+void Axis::extend_move(int32_t increment) {
+    bool forwards = (increment > 0);
+
+    if(!moving() || forwards != (direction == Axis::Positive)) {
+        move_incremental(increment);
+        extending = true;
+
+        return;
+    }
+
+    int32_t position = (int32_t)desired_position + increment;
+
+    if(position < 0) {
+        position = 0;
+    }
+
+    desired_position = min((uint32_t)position, 16000);
+    extending = true;
+}
+
 void Axis::move_to_positive(void) {
     set_direction(Axis::Positive);
     motor->set_speed(desired_speed);
@@ -323,8 +399,17 @@ void Axis::wait_for_move(void) {
 }
 
 void Axis::set_speed(uint32_t mm_per_minute) {
-    desired_speed = mm_per_minute;
+    desired_speed = min(mm_per_minute, max_speed);
     motor->set_speed(desired_speed);
+    ramp_speed = desired_speed;
+}
+
+void Axis::set_max_speed(uint32_t mm_per_minute) {
+    max_speed = mm_per_minute;
+
+    if(desired_speed > max_speed) {
+        set_speed(max_speed);
+    }
 }
 
 void Axis::set_acceleration(bool acc) {
@@ -365,38 +450,55 @@ Stepper * Axis::get_motor(void) {
     return motor;
 }
 
+void Axis::set_firing_queue(FiringQueue *queue) {
+    firing_queue = queue;
+}
+
 void Axis::debug_info(void) {
-    LoggerWrapper &info = logger.info() << axis << " axis, ";
+    LoggerWrapper<Logger::Info> &info = logger.info() << axis << F(" axis, ");
 
     if(motor == &a_motor) {
-        info << "a";
+        info << F("a");
     } else {
-        info << "b";
+        info << F("b");
     }
 
-    info << " motor, ";
+    info << F(" motor, ");
 
     if(direction == Axis::Positive) {
-        info << "+";
+        info << F("+");
     } else {
-        info << "-";
+        info << F("-");
     }
 
-    info << " direction, ";
+    info << F(" direction, ");
 
     if(motor->get_direction() == Stepper::CW) {
-        info << "CW";
+        info << F("CW");
     } else {
-        info << "CCW";
+        info << F("CCW");
     }
 
-    info << " motor";
+    info << F(" motor");
 
     if(motor_mapping == CW_Positive) {
-        info << " (+CW STD)";
+        info << F(" (+CW STD)");
     } else {
-        info << " (-CW INV)";
+        info << F(" (-CW INV)");
     }
 
     info << Comms::endl;
 }
+
+void Axis::reset_jitter(void) {
+    memset(&jitter, 0, sizeof(jitter));
+}
+
+void Axis::print_jitter(void) {
+#if JITTER
+    logger.info() << axis << F(": ") << jitter.steps << F(" steps, late by ")
+            << (jitter.steps ? jitter.late_total / jitter.steps : 0)
+            << F(" us average, ") << jitter.late_max << F(" us max, ")
+            << jitter.late_steps << F(" over half a step late") << Comms::endl;
+#endif
+}
@@ -24,6 +24,25 @@
 
 #include "utils.h"
 #include "stepper.h"
+#include "firing.h"
+
+// How far actual steps fall behind the speed asked for, over steps taken
+// back to back. Steps are polled, so each one comes some time after it was
+// due; it is counted as late once that is more than half an interval.
+// Build with JITTER=0 to take no samples; the counts then stay at zero.
+//
+//   make JITTER=0
+
+#ifndef JITTER
+#define JITTER 1
+#endif
+
+struct StepJitter {
+    uint32_t steps;
+    uint32_t late_total;
+    uint32_t late_max;
+    uint32_t late_steps;
+};
 
 class Axis {
 public:
@@ -55,6 +74,13 @@ public:
     void move_incremental(double increment);
     void move_incremental(int32_t increment);
 
+    // Like move_incremental but keeps the current acceleration ramp going
+    // when the axis is already moving in the same direction. The move ramps
+    // over the full acc_steps however short it is so far, and never runs
+    // faster than it could stop in what is left of it, so it slows down on
+    // its own when no more is added.
+    void extend_move(int32_t increment);
+
     void move_to_positive(void);
     void move_to_negative(void);
 
@@ -70,6 +96,7 @@ public:
     void wait_for_move(void);
 
     void set_speed(uint32_t mm_per_minute);
+    void set_max_speed(uint32_t mm_per_minute);
     void set_acceleration(bool acc);
 
     void set_motor_mapping(uint8_t motor_mapping);
@@ -78,6 +105,8 @@ public:
     void set_motor(Stepper *motor);
     Stepper * get_motor(void);
 
+    void set_firing_queue(FiringQueue *queue);
+
     static const long steps_per_mm = 80;
 
     uint32_t start_position;
@@ -87,6 +116,10 @@ public:
 
     void debug_info(void);
 
+    StepJitter jitter;
+    void reset_jitter(void);
+    void print_jitter(void);
+
 private:
     enum StepDirection {
         Positive = 0,
@@ -102,6 +135,7 @@ private:
     bool (*negative_limit)(void);
 
     Stepper *motor;
+    FiringQueue *firing_queue;
 
     uint8_t direction;
 
@@ -109,7 +143,11 @@ private:
 
     uint32_t desired_position;
     uint32_t desired_speed;
+    uint32_t max_speed;
     bool acceleration;
+    bool extending;
+    bool stepping;
+    uint32_t ramp_speed;        // last speed given to the motor by the ramp
 };
 
 #endif
@@ -0,0 +1,330 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "blockio.h"
+
+BlockReader::BlockReader() {
+    file = NULL;
+    buffer = NULL;
+    streaming = false;
+    index = 0;
+    length = 0;
+    remaining = 0;
+    fragments = 0;
+}
+
+bool BlockReader::open(SdVolume *vol, SdBaseFile *file, uint8_t *buffer) {
+    close();
+
+    if(buffer == NULL || !file->isOpen() || file->isDir()) {
+        return false;
+    }
+
+    this->vol = vol;
+    this->buffer = buffer;
+    this->card = vol->sdCard();
+    this->file = file;
+
+    index = 0;
+    length = 0;
+    remaining = file->fileSize();
+    fragments = 0;
+
+    if(remaining == 0) {
+        return true;
+    }
+
+    // Anything still dirty in the volume cache has to reach the card first,
+    // the stream reads around it.
+    if(!vol->cacheClear()) {
+        this->file = NULL;
+        return false;
+    }
+
+    uint32_t first, last;
+
+    if(file->contiguousRange(&first, &last)) {
+        // One run for the whole file
+        block = first;
+        run_end = last;
+        run_cluster = 0;
+    } else if(!start_run(file->firstCluster())) {
+        this->file = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+void BlockReader::close(void) {
+    if(streaming) {
+        card->readStop();
+        streaming = false;
+    }
+
+    file = NULL;
+    buffer = NULL;
+    index = 0;
+    length = 0;
+    remaining = 0;
+}
+
+// Finds how far the cluster chain runs on contiguously from cluster.
+bool BlockReader::start_run(uint32_t cluster) {
+    uint32_t last = cluster;
+    uint32_t clusters = 1;
+    uint32_t needed = ((remaining - 1) >> (vol->clusterSizeShift() + 9)) + 1;
+
+    while(clusters < needed) {
+        uint32_t next;
+
+        if(!vol->nextCluster(last, &next)) {
+            return false;
+        }
+
+        if(next != last + 1) {
+            break;
+        }
+
+        last = next;
+        clusters++;
+    }
+
+    block = vol->dataStartBlock() + ((cluster - 2) << vol->clusterSizeShift());
+    run_end = block + (clusters << vol->clusterSizeShift()) - 1;
+    run_cluster = last;
+
+    return true;
+}
+
+bool BlockReader::fill(void) {
+    if(file == NULL || remaining == 0) {
+        return false;
+    }
+
+    if(block > run_end) {
+        // Fragment boundary, the FAT can only be read once the stream stops
+        if(streaming) {
+            card->readStop();
+            streaming = false;
+        }
+
+        uint32_t next;
+
+        if(!vol->nextCluster(run_cluster, &next) || !start_run(next)) {
+            close();
+            return false;
+        }
+
+        fragments++;
+    }
+
+    if(!streaming) {
+        if(!card->readStart(block)) {
+            close();
+            return false;
+        }
+
+        streaming = true;
+    }
+
+    if(!card->readData(buffer)) {
+        streaming = false;
+        close();
+        return false;
+    }
+
+    block++;
+    SdVolume::cacheStats.streamed++;
+
+    length = remaining < BLOCK_SIZE ? remaining : BLOCK_SIZE;
+    remaining -= length;
+    index = 0;
+
+    if(remaining == 0) {
+        card->readStop();
+        streaming = false;
+    }
+
+    return true;
+}
+
+int BlockReader::read(void *dst, uint16_t count) {
+    uint8_t *out = (uint8_t *)dst;
+    uint16_t done = 0;
+
+    while(done < count) {
+        if(index >= length && !fill()) {
+            break;
+        }
+
+        uint16_t n = length - index;
+
+        if(n > count - done) {
+            n = count - done;
+        }
+
+        memcpy(out + done, buffer + index, n);
+        index += n;
+        done += n;
+    }
+
+    return done;
+}
+
+BlockWriter::BlockWriter() {
+    card = NULL;
+    remaining = 0;
+    finished = false;
+    queued = 0;
+    failed = false;
+}
+
+// Leaving the card part way through a CMD25 would break every later
+// access, so make sure the stream is stopped on early returns.
+BlockWriter::~BlockWriter() {
+    close();
+}
+
+bool BlockWriter::open(SdVolume *vol, SdBaseFile *file) {
+    close();
+
+    uint32_t first, last;
+
+    if(!file->isOpen() || !file->contiguousRange(&first, &last)) {
+        return false;
+    }
+
+    // The data blocks are written behind the cache's back.
+    if(!vol->cacheClear()) {
+        return false;
+    }
+
+    remaining = (file->fileSize() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    if(!vol->sdCard()->writeStart(first, remaining)) {
+        return false;
+    }
+
+    this->vol = vol;
+    this->card = vol->sdCard();
+    finished = false;
+    queued = 0;
+    failed = false;
+
+    return true;
+}
+
+bool BlockWriter::close(void) {
+    if(card == NULL) {
+        return true;
+    }
+
+    bool ok = card->writeStop();
+
+    card = NULL;
+    queued = 0;
+
+    return ok && remaining == 0;
+}
+
+bool BlockWriter::write(const void *src, uint16_t count) {
+    const uint8_t *in = (const uint8_t *)src;
+
+    if(card == NULL || finished) {
+        return false;
+    }
+
+    while(count > 0) {
+        if(remaining == 0) {
+            return false;
+        }
+
+        if(count < BLOCK_SIZE) {
+            // The cache was cleared in open() and nothing else touches the
+            // volume until close(), so it can hold the padded last block.
+            uint8_t *tail = vol->cacheClear()->data;
+
+            memcpy(tail, in, count);
+            memset(tail + count, 0, BLOCK_SIZE - count);
+
+            in = tail;
+            count = BLOCK_SIZE;
+            finished = true;
+        }
+
+        if(!card->writeData(in)) {
+            finished = true;
+            return false;
+        }
+
+        in += BLOCK_SIZE;
+        count -= BLOCK_SIZE;
+        remaining--;
+    }
+
+    return true;
+}
+
+bool BlockWriter::queue(const void *src, uint16_t count) {
+    if(card == NULL || !flush()) {
+        return false;
+    }
+
+    queued_data = (const uint8_t *)src;
+    queued = count;
+
+    return true;
+}
+
+bool BlockWriter::write_next(void) {
+    uint16_t n = queued < BLOCK_SIZE ? queued : BLOCK_SIZE;
+
+    if(!write(queued_data, n)) {
+        failed = true;
+        queued = 0;
+        return false;
+    }
+
+    queued_data += n;
+    queued -= n;
+
+    return true;
+}
+
+bool BlockWriter::service(void) {
+    if(queued == 0 || card->isBusy()) {
+        return !failed;
+    }
+
+    return write_next();
+}
+
+bool BlockWriter::flush(void) {
+    while(queued > 0) {
+        // writeData() waits for the card itself
+        if(!write_next()) {
+            break;
+        }
+    }
+
+    return !failed;
+}
@@ -0,0 +1,138 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _BLOCKIO_H_
+#define _BLOCKIO_H_
+
+#include <Arduino.h>
+
+#include "SdFat/SdFat.h"
+
+#define BLOCK_SIZE 512
+
+// Sequential reader for print playback. Streams each contiguous run of
+// clusters with one multi-block read (CMD18) straight into a block buffer,
+// instead of a CMD17 per block through the volume cache, and only stops at
+// fragment boundaries to look up the next run in the FAT. The caller lends
+// the BLOCK_SIZE buffer, normally from the I/O arena, until close().
+class BlockReader {
+public:
+    BlockReader();
+
+    bool open(SdVolume *vol, SdBaseFile *file, uint8_t *buffer);
+    void close(void);
+
+    bool is_open(void) {
+        return file != NULL;
+    }
+
+    inline int read(void) {
+        if(index >= length && !fill()) {
+            return -1;
+        }
+
+        return buffer[index++];
+    }
+
+    inline int peek(void) {
+        if(index >= length && !fill()) {
+            return -1;
+        }
+
+        return buffer[index];
+    }
+
+    int read(void *dst, uint16_t count);
+
+    uint32_t available(void) {
+        return remaining + (length - index);
+    }
+
+    // Fragments crossed so far, each one costs a stop and a FAT lookup.
+    uint16_t fragments;
+
+private:
+    bool fill(void);
+    bool start_run(uint32_t cluster);
+
+    SdVolume *vol;
+    Sd2Card *card;
+    SdBaseFile *file;
+
+    uint8_t *buffer;
+    uint16_t index;
+    uint16_t length;
+
+    uint32_t remaining;
+
+    uint32_t block;
+    uint32_t run_end;
+    uint32_t run_cluster;
+    bool streaming;
+};
+
+// Sequential writer for files made with SdBaseFile::createContiguous. The
+// whole file goes out as one multi-block write (CMD25) with the blocks
+// pre-erased, so no clusters are allocated and no FAT or directory blocks
+// are touched while data is being written.
+class BlockWriter {
+public:
+    BlockWriter();
+    ~BlockWriter();
+
+    bool open(SdVolume *vol, SdBaseFile *file);
+    bool close(void);
+
+    bool is_open(void) {
+        return card != NULL;
+    }
+
+    // Every write except the last must be a whole number of blocks, the
+    // last one is padded out with zeros.
+    bool write(const void *src, uint16_t count);
+
+    // Write-behind: queue() hands over a buffer that service() then writes
+    // a block at a time, only when the card has finished programming the
+    // previous one, so the caller never waits on it. The buffer must be
+    // left alone until pending() is false. close() drops anything queued.
+    bool queue(const void *src, uint16_t count);
+    bool service(void);
+    bool flush(void);
+
+    bool pending(void) {
+        return queued > 0;
+    }
+
+private:
+    bool write_next(void);
+
+    SdVolume *vol;
+    Sd2Card *card;
+
+    uint32_t remaining;
+    bool finished;
+
+    const uint8_t *queued_data;
+    uint16_t queued;
+    bool failed;
+};
+
+#endif
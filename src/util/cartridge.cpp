@@ -20,12 +20,72 @@
 */
 
 #include "cartridge.h"
+#include "nozzles.h"
+#include "hal.h"
+#include "profile.h"
+#include "trace.h"
+#include "telemetry.h"
+
+static uint8_t pulse_width = CARTRIDGE_DEFAULT_PULSE_WIDTH;
+static uint16_t recovery_time = CARTRIDGE_DEFAULT_RECOVERY_TIME;
+
+static uint16_t pulse_ticks;
+static uint16_t recovery_ticks;
+
+static volatile bool recovering = false;
 
 void cartridge_initialise(void) {
     // Configure Cartridge Ports
-    DDRC = 0xFF;
-    DDRL = 0xFF;
-    DDRA = 0xFF;
+    hal_cartridge_initialise();
+    hal_timer_initialise();
+
+    cartridge_set_timing(pulse_width, recovery_time);
+}
+
+HAL_TIMER_ALARM {
+    // Recovery is over. Running late here only makes the head wait longer.
+    hal_timer_alarm_cancel();
+    recovering = false;
+}
+
+bool cartridge_set_timing(uint8_t width, uint16_t recovery) {
+    if(width == 0 || width > CARTRIDGE_MAX_PULSE_WIDTH) {
+        return false;
+    }
+
+    // Has to fit in a Timer1 period along with the pulse
+    if(recovery < CARTRIDGE_MIN_RECOVERY_TIME || recovery > 30000) {
+        return false;
+    }
+
+    while(recovering) {
+        hal_poll();
+    }
+
+    pulse_width = width;
+    recovery_time = recovery;
+
+    pulse_ticks = width * HAL_TIMER_TICKS_PER_US;
+    recovery_ticks = recovery * HAL_TIMER_TICKS_PER_US;
+
+    return true;
+}
+
+uint8_t cartridge_pulse_width(void) {
+    return pulse_width;
+}
+
+uint16_t cartridge_recovery_time(void) {
+    return recovery_time;
+}
+
+bool cartridge_ready(void) {
+    return !recovering;
+}
+
+uint32_t cartridge_max_frequency(void) {
+    // Plus about a microsecond of address setup and hold
+    return 1000000UL / (pulse_width + recovery_time + 1);
 }
 
 // PORT C is [R1, R2, R3, R4, L1, L2, L3, L4] (Multiplexer)
@@ -34,6 +94,40 @@ void cartridge_initialise(void) {
 
 // Put in to a printhead class
 
+// Timed off the pulse timer with interrupts held off so that no interrupt
+// can stretch the pulse. The address must already be set up.
+static inline void pulse_primitives(uint8_t rPrim, uint8_t lPrim) {
+    uint8_t state = hal_irq_save();
+
+    uint16_t start = hal_timer_ticks();
+
+    hal_cartridge_primitives(rPrim, lPrim);
+
+    // Flag the end of recovery from the timer alarm. Armed while the pulse
+    // is still on: the alarm only goes off on an exact match, and a short
+    // recovery can be over before the pulse code is done.
+    hal_timer_alarm(start + pulse_ticks + recovery_ticks);
+    recovering = true;
+
+    while((uint16_t)(hal_timer_ticks() - start) < pulse_ticks);
+
+    hal_cartridge_primitives(0, 0);
+
+#if TELEMETRY
+    if(rPrim | lPrim) {
+        telemetry.firings++;
+    }
+#endif
+
+    // Past it already, the alarm would wait for the timer to come round
+    if((uint16_t)(hal_timer_ticks() - start) >= pulse_ticks + recovery_ticks) {
+        hal_timer_alarm_cancel();
+        recovering = false;
+    }
+
+    hal_irq_restore(state);
+}
+
 /*
 
 .global _Z8fireHeadhhhh
@@ -53,7 +147,6 @@ _Z8fireHeadhhhh:
 */
 
 void fire_head(uint8_t rPrim, uint8_t rAddr, uint8_t lPrim, uint8_t lAddr) {
-    int x1, x2;
     /*
 
         // prologue: function
@@ -78,6 +171,13 @@ void fire_head(uint8_t rPrim, uint8_t rAddr, uint8_t lPrim, uint8_t lAddr) {
 
     */
     if (rPrim || rAddr || lPrim || lAddr) {
+        uint16_t start = profile_begin();
+
+        // Don't fire again until the last pulse has recovered
+        while(recovering) {
+            hal_poll();
+        }
+
         /*
 
             .L25:
@@ -117,17 +217,10 @@ void fire_head(uint8_t rPrim, uint8_t rAddr, uint8_t lPrim, uint8_t lAddr) {
         // 2.5µS inner (t_pw)
 
         // Address
-        PORTC = (PORTC | int(lAddr));
-        PORTC = (PORTC | (int(rAddr) << 4));
-
-        asm volatile("nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-        );
+        hal_cartridge_address(lAddr);
+        hal_cartridge_address(lAddr | (rAddr << 4));
+
+        hal_cartridge_settle();
 
         /*
 
@@ -148,49 +241,9 @@ void fire_head(uint8_t rPrim, uint8_t rAddr, uint8_t lPrim, uint8_t lAddr) {
         */
 
         // Primitives
-        PORTL = int(lPrim);
-        PORTA = int(rPrim);
-
-        delayMicroseconds(6);
-
-        asm volatile("nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-        );
-
-        /*
-
-            ldi r30,lo8(34)
-            ldi r31,hi8(34)
-            st Z,__zero_reg__
-
-            ldi r30,lo8(267)
-            ldi r31,hi8(267)
-            st Z,__zero_reg__
-
-        */
-        PORTA = 0;
-        PORTL = 0;
+        pulse_primitives(rPrim, lPrim);
 
-        asm volatile("nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t"
-                     "nop\n\t");
+        hal_cartridge_settle();
 
         /*
 
@@ -199,7 +252,87 @@ void fire_head(uint8_t rPrim, uint8_t rAddr, uint8_t lPrim, uint8_t lAddr) {
             st Z,__zero_reg__
 
         */
-        PORTC = 0;
+        hal_cartridge_address(0);
         //delayMicroseconds(500);
+
+        if (rAddr == lAddr) {
+            uint8_t slot = cartridge_address_slot(rAddr);
+
+            if (slot < CARTRIDGE_ADDRESSES)
+                nozzles_count(slot, rPrim, lPrim);
+        }
+
+        profile_end(PROFILE_FIRE, start);
+
+        trace(TRACE_FIRE, lAddr | (rAddr << 4), (rPrim << 8) | lPrim);
+    }
+}
+
+// PORTC value for each column slot, both cartridges on the same address, in
+// the firing order decb writes them: 8 4 C 2 A 6 E 1 9 5 D 3 B.
+static const uint8_t column_ports[CARTRIDGE_ADDRESSES] PROGMEM = {
+    0x88, 0x44, 0xCC, 0x22, 0xAA, 0x66, 0xEE,
+    0x11, 0x99, 0x55, 0xDD, 0x33, 0xBB
+};
+
+// Column slot for each address, 0xFF for addresses outside the column.
+static const uint8_t address_slots[16] PROGMEM = {
+    0xFF,    7,    3,   11,    1,    9,    5, 0xFF,
+       0,    8,    4,   12,    2,   10,    6, 0xFF
+};
+
+uint8_t cartridge_address_slot(uint8_t address) {
+    return pgm_read_byte(&address_slots[address & 0x0F]);
+}
+
+// One whole column in a single pass: no per-record parsing or call overhead,
+// addresses come straight from the table and slots with nothing to fire are
+// skipped. Addresses are spaced by the recovery time only.
+void fire_column(const uint8_t prim[CARTRIDGE_ADDRESSES][2]) {
+    uint16_t start = profile_begin();
+    uint16_t fired = 0;
+    uint8_t count = 0;
+
+    for(uint8_t slot = 0; slot < CARTRIDGE_ADDRESSES; slot++) {
+        uint8_t rPrim = prim[slot][0];
+        uint8_t lPrim = prim[slot][1];
+
+        if(!(rPrim | lPrim)) {
+            continue;
+        }
+
+        fired |= 1 << slot;
+        count++;
+
+        uint8_t address = pgm_read_byte(&column_ports[slot]);
+
+        while(recovering) {
+            hal_poll();
+        }
+
+        // Address setup
+        hal_cartridge_address(address);
+        hal_cartridge_settle();
+
+        pulse_primitives(rPrim, lPrim);
+
+        // Address hold
+        hal_cartridge_settle();
+        hal_cartridge_address(0);
+    }
+
+    // Counted while the last address recovers rather than between pulses
+    for(uint8_t slot = 0; slot < CARTRIDGE_ADDRESSES; slot++) {
+        if(fired & (1 << slot)) {
+            nozzles_count(slot, prim[slot][0], prim[slot][1]);
+        }
+    }
+
+    profile_end(PROFILE_FIRE, start);
+
+    // One event for the column, after the last address, so that tracing
+    // neither spaces the addresses out nor fills the ring with one column
+    if(fired) {
+        trace(TRACE_COLUMN, count, fired);
     }
 }
@@ -24,7 +24,34 @@
 
 #include <Arduino.h>
 
+// Firing pulse timing. The pulse is timed by Timer1 with interrupts held off,
+// so it cannot be stretched. The recovery time after each pulse is tracked by
+// a Timer1 compare interrupt and fire_head() returns without waiting for it;
+// the next firing waits only for whatever is left of it.
+#define CARTRIDGE_DEFAULT_PULSE_WIDTH   6 // us
+#define CARTRIDGE_DEFAULT_RECOVERY_TIME 2 // us
+#define CARTRIDGE_MIN_RECOVERY_TIME     2 // us
+#define CARTRIDGE_MAX_PULSE_WIDTH      20 // us
+
+// Primitives per firing column, one per address.
+#define CARTRIDGE_ADDRESSES 13
+
 void cartridge_initialise(void);
 void fire_head(uint8_t rPrim, uint8_t rAddr, uint8_t lPrim, uint8_t lAddr);
 
+// Fires a whole column. prim[slot] holds the right and left primitives for
+// the slot'th address in firing order, see cartridge_address_slot().
+void fire_column(const uint8_t prim[CARTRIDGE_ADDRESSES][2]);
+uint8_t cartridge_address_slot(uint8_t address);
+
+bool cartridge_set_timing(uint8_t pulse_width, uint16_t recovery_time);
+uint8_t cartridge_pulse_width(void);
+uint16_t cartridge_recovery_time(void);
+
+// False while the head is still recovering from the last pulse.
+bool cartridge_ready(void);
+
+// Highest rate, in firings per second, the timing above allows.
+uint32_t cartridge_max_frequency(void);
+
 #endif
@@ -0,0 +1,405 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "catalogue.h"
+
+#define SCAN_LINE   0
+#define SCAN_MOVE   1
+#define SCAN_AXIS   2
+#define SCAN_SPACE  3
+#define SCAN_VALUE  4
+#define SCAN_END    5
+#define SCAN_SKIP   6
+
+void catalogue_scan_init(JobScan *scan) {
+    memset(scan, 0, sizeof(JobScan));
+    scan->state = SCAN_LINE;
+}
+
+static void catalogue_scan_move(JobScan *scan) {
+    int32_t steps = scan->negative ? -scan->value : scan->value;
+
+    if(scan->axis == 'X') {
+        scan->x = steps == 0 ? 0 : scan->x + steps;
+
+        if(scan->x < scan->min_x) {
+            scan->min_x = scan->x;
+        }
+
+        if(scan->x > scan->max_x) {
+            scan->max_x = scan->x;
+        }
+    } else if(scan->axis == 'Y') {
+        scan->y = steps == 0 ? 0 : scan->y + steps;
+
+        if(scan->y < scan->min_y) {
+            scan->min_y = scan->y;
+        }
+
+        if(scan->y > scan->max_y) {
+            scan->max_y = scan->y;
+        }
+    }
+}
+
+void catalogue_scan(JobScan *scan, const uint8_t *data, uint16_t length) {
+    for(uint16_t i = 0; i < length; i++) {
+        uint8_t c = data[i];
+
+        if(c == '\n') {
+            if(scan->state == SCAN_VALUE || scan->state == SCAN_END) {
+                catalogue_scan_move(scan);
+            }
+
+            scan->state = SCAN_LINE;
+            continue;
+        }
+
+        switch(scan->state) {
+            case SCAN_LINE:
+                scan->state = c == 'M' ? SCAN_MOVE : SCAN_SKIP;
+                break;
+
+            case SCAN_MOVE:
+                scan->state = c == ' ' ? SCAN_AXIS : SCAN_SKIP;
+                break;
+
+            case SCAN_AXIS:
+                scan->axis = c;
+                scan->state = SCAN_SPACE;
+                break;
+
+            case SCAN_SPACE:
+                scan->value = 0;
+                scan->negative = false;
+                scan->state = c == ' ' ? SCAN_VALUE : SCAN_SKIP;
+                break;
+
+            case SCAN_VALUE:
+                if(c >= '0' && c <= '9') {
+                    scan->value = scan->value * 10 + (c - '0');
+                } else if(c == '-' && scan->value == 0) {
+                    scan->negative = true;
+                } else {
+                    // atol() stops here too
+                    scan->state = SCAN_END;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void catalogue_scan_bounds(JobScan *scan, JobRecord *record) {
+    record->min_x = scan->min_x;
+    record->min_y = scan->min_y;
+    record->max_x = scan->max_x;
+    record->max_y = scan->max_y;
+    record->flags |= JOB_BOUNDS;
+}
+
+bool catalogue_describe(SdBaseFile *file, JobRecord *record) {
+    dir_t entry;
+
+    memset(record, 0, sizeof(JobRecord));
+
+    if(!file->getFilename(record->name) || !file->dirEntry(&entry)) {
+        return false;
+    }
+
+    record->size = file->fileSize();
+    record->cluster = file->firstCluster();
+    record->date = entry.lastWriteDate;
+    record->time = entry.lastWriteTime;
+
+    return true;
+}
+
+static bool catalogue_same_file(const JobRecord *a, const JobRecord *b) {
+    return a->size == b->size &&
+           a->cluster == b->cluster &&
+           a->date == b->date &&
+           a->time == b->time;
+}
+
+static bool catalogue_header_valid(CatalogueHeader *header) {
+    return header->magic == CATALOGUE_MAGIC &&
+           header->version == CATALOGUE_VERSION &&
+           header->record_size == sizeof(JobRecord);
+}
+
+bool catalogue_open(SdBaseFile *dir, SdBaseFile *catalogue) {
+    CatalogueHeader header;
+
+    if(!catalogue->open(dir, CATALOGUE_FILE, O_READ)) {
+        return false;
+    }
+
+    if(catalogue->read(&header, sizeof(header)) != sizeof(header) ||
+            !catalogue_header_valid(&header)) {
+        catalogue->close();
+        return false;
+    }
+
+    return true;
+}
+
+// Opens the catalogue for update. One from another version is only a
+// cache of what's on the card, so it is started again rather than
+// converted, and anything missing gets filled in as files are used.
+static bool catalogue_open_update(SdBaseFile *dir, SdBaseFile *catalogue,
+                                  CatalogueHeader *header) {
+    if(!catalogue->open(dir, CATALOGUE_FILE, O_RDWR)) {
+        SdBaseFile::remove(dir, CATALOGUE_LEGACY_FILE);
+
+        if(!catalogue->open(dir, CATALOGUE_FILE, O_RDWR | O_CREAT)) {
+            return false;
+        }
+    }
+
+    if(catalogue->read(header, sizeof(CatalogueHeader)) ==
+                sizeof(CatalogueHeader) &&
+            catalogue_header_valid(header)) {
+        return true;
+    }
+
+    header->magic = CATALOGUE_MAGIC;
+    header->version = CATALOGUE_VERSION;
+    header->record_size = sizeof(JobRecord);
+    header->prints = 0;
+
+    if(!catalogue->truncate(0) ||
+            catalogue->write(header, sizeof(CatalogueHeader)) !=
+                sizeof(CatalogueHeader)) {
+        catalogue->close();
+        return false;
+    }
+
+    return true;
+}
+
+bool catalogue_next(SdBaseFile *catalogue, JobRecord *record) {
+    while(catalogue->read(record, sizeof(JobRecord)) == sizeof(JobRecord)) {
+        if(record->name[0] != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Position of the record called name, or -1. Also reports the first free
+// slot, or the end of the catalogue if there isn't one.
+static int32_t catalogue_position(SdBaseFile *catalogue, const char *name,
+                                  JobRecord *record, int32_t *free_slot) {
+    int32_t position = sizeof(CatalogueHeader);
+
+    if(free_slot) {
+        *free_slot = -1;
+    }
+
+    catalogue->seekSet(position);
+
+    while(catalogue->read(record, sizeof(JobRecord)) == sizeof(JobRecord)) {
+        if(record->name[0] == 0) {
+            if(free_slot && *free_slot < 0) {
+                *free_slot = position;
+            }
+        } else if(strcmp(record->name, name) == 0) {
+            return position;
+        }
+
+        position += sizeof(JobRecord);
+    }
+
+    if(free_slot && *free_slot < 0) {
+        *free_slot = position;
+    }
+
+    return -1;
+}
+
+static bool catalogue_write(SdBaseFile *catalogue, int32_t position,
+                            const void *data, uint16_t length) {
+    return catalogue->seekSet(position) &&
+           catalogue->write(data, length) == length;
+}
+
+bool catalogue_find(SdBaseFile *dir, SdBaseFile *file, JobRecord *record) {
+    JobRecord current;
+    SdBaseFile catalogue;
+
+    if(!catalogue_describe(file, &current)) {
+        return false;
+    }
+
+    if(!catalogue_open(dir, &catalogue)) {
+        return false;
+    }
+
+    bool found = catalogue_position(&catalogue, current.name, record, NULL) >= 0;
+
+    catalogue.close();
+
+    return found && catalogue_same_file(record, &current);
+}
+
+bool catalogue_store(SdBaseFile *dir, JobRecord *record) {
+    CatalogueHeader header;
+    JobRecord existing;
+    SdBaseFile catalogue;
+    int32_t free_slot;
+
+    if(!catalogue_open_update(dir, &catalogue, &header)) {
+        return false;
+    }
+
+    int32_t position = catalogue_position(&catalogue, record->name, &existing,
+                                          &free_slot);
+
+    if(position < 0) {
+        position = free_slot;
+    }
+
+    bool ok = catalogue_write(&catalogue, position, record, sizeof(JobRecord));
+
+    return catalogue.close() && ok;
+}
+
+void catalogue_remove(SdBaseFile *dir, const char *name) {
+    CatalogueHeader header;
+    JobRecord record;
+    SdBaseFile catalogue;
+
+    if(!catalogue_open_update(dir, &catalogue, &header)) {
+        return;
+    }
+
+    int32_t position = catalogue_position(&catalogue, name, &record, NULL);
+
+    if(position >= 0) {
+        memset(&record, 0, sizeof(JobRecord));
+        catalogue_write(&catalogue, position, &record, sizeof(JobRecord));
+    }
+
+    catalogue.close();
+}
+
+bool catalogue_printed(SdBaseFile *dir, SdBaseFile *file,
+                       int32_t min_x, int32_t min_y,
+                       int32_t max_x, int32_t max_y) {
+    CatalogueHeader header;
+    JobRecord current;
+    JobRecord record;
+    SdBaseFile catalogue;
+    int32_t free_slot;
+
+    if(!catalogue_describe(file, &current) ||
+            !catalogue_open_update(dir, &catalogue, &header)) {
+        return false;
+    }
+
+    int32_t position = catalogue_position(&catalogue, current.name, &record,
+                                          &free_slot);
+
+    if(position < 0 || !catalogue_same_file(&record, &current)) {
+        if(position < 0) {
+            position = free_slot;
+        }
+
+        memcpy(&record, &current, sizeof(JobRecord));
+    }
+
+    header.prints++;
+
+    record.min_x = min_x;
+    record.min_y = min_y;
+    record.max_x = max_x;
+    record.max_y = max_y;
+    record.flags |= JOB_BOUNDS;
+    record.last_printed = header.prints;
+
+    bool ok = catalogue_write(&catalogue, position, &record, sizeof(JobRecord)) &&
+              catalogue_write(&catalogue, 0, &header, sizeof(CatalogueHeader));
+
+    return catalogue.close() && ok;
+}
+
+int16_t catalogue_rescan(SdBaseFile *dir) {
+    CatalogueHeader header;
+    JobRecord current;
+    JobRecord record;
+    SdBaseFile catalogue;
+    SdBaseFile file;
+    int16_t count = 0;
+
+    if(!catalogue_open_update(dir, &catalogue, &header)) {
+        return -1;
+    }
+
+    // Drop records for files that have gone or changed
+    int32_t position = sizeof(CatalogueHeader);
+
+    while(catalogue.read(&record, sizeof(JobRecord)) == sizeof(JobRecord)) {
+        if(record.name[0] != 0) {
+            bool keep = file.open(dir, record.name, O_READ) &&
+                        catalogue_describe(&file, &current) &&
+                        catalogue_same_file(&record, &current);
+
+            file.close();
+
+            if(keep) {
+                count++;
+            } else {
+                memset(&record, 0, sizeof(JobRecord));
+                catalogue_write(&catalogue, position, &record, sizeof(JobRecord));
+            }
+        }
+
+        position += sizeof(JobRecord);
+        catalogue.seekSet(position);
+    }
+
+    // Add print files that aren't listed
+    dir->rewind();
+
+    while(file.openNext(dir, O_READ)) {
+        if(!file.isDir() && catalogue_describe(&file, &current) &&
+                strstr(current.name, ".HEX")) {
+            int32_t free_slot;
+
+            if(catalogue_position(&catalogue, current.name, &record,
+                                  &free_slot) < 0 &&
+                    catalogue_write(&catalogue, free_slot, &current,
+                                    sizeof(JobRecord))) {
+                count++;
+            }
+        }
+
+        file.close();
+    }
+
+    catalogue.close();
+
+    return count;
+}
@@ -0,0 +1,122 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _CATALOGUE_H_
+#define _CATALOGUE_H_
+
+#include <Arduino.h>
+
+#include "SdFat/SdFat.h"
+
+// Catalogue of the jobs on the card, kept in its root so ls, md5 and djb2
+// can answer without walking the directory or reading the files again.
+// The file starts with a CatalogueHeader followed by fixed size records,
+// a record with an empty name is a free slot.
+#define CATALOGUE_FILE "JOBS.IDX"
+#define CATALOGUE_MAGIC 0x4A4F4243L   // "JOBC"
+#define CATALOGUE_VERSION 3
+
+// Version 1 was a bare list of hashes
+#define CATALOGUE_LEGACY_FILE "HASHES.IDX"
+
+// Which of the optional parts of a record are known
+#define JOB_DJB2   0x01
+#define JOB_MD5    0x02
+#define JOB_BOUNDS 0x04
+#define JOB_CRC32  0x08
+
+#pragma pack(push, 1)
+
+struct CatalogueHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t record_size;
+    uint32_t prints;        // jobs printed so far, stamps last_printed
+};
+
+struct JobRecord {
+    char name[13];          // 8.3 name, empty for a free slot
+    uint32_t size;
+    uint32_t cluster;       // first cluster
+    uint16_t date;          // last write stamp from the directory entry
+    uint16_t time;
+    uint8_t flags;
+    uint32_t djb2;
+    uint8_t md5[16];
+    uint32_t crc32;
+    int32_t min_x;          // extent of the moves, in steps from the start
+    int32_t min_y;
+    int32_t max_x;
+    int32_t max_y;
+    uint32_t last_printed;  // header prints count when last printed, 0 never
+};
+
+#pragma pack(pop)
+
+// Follows the moves in a print file as it streams past, the same way
+// readFile() does, to find the extent of the job.
+struct JobScan {
+    int32_t x;
+    int32_t y;
+    int32_t min_x;
+    int32_t min_y;
+    int32_t max_x;
+    int32_t max_y;
+    int32_t value;
+    char axis;
+    uint8_t state;
+    bool negative;
+};
+
+void catalogue_scan_init(JobScan *scan);
+void catalogue_scan(JobScan *scan, const uint8_t *data, uint16_t length);
+void catalogue_scan_bounds(JobScan *scan, JobRecord *record);
+
+// Fills in the identifying part of record from an open file and clears
+// everything else.
+bool catalogue_describe(SdBaseFile *file, JobRecord *record);
+
+// Looks up the record for an open file. Only succeeds if the size, first
+// cluster and stamp still match, anything else means the file has been
+// replaced behind the catalogue's back.
+bool catalogue_find(SdBaseFile *dir, SdBaseFile *file, JobRecord *record);
+
+// Adds record, replacing any older one with the same name.
+bool catalogue_store(SdBaseFile *dir, JobRecord *record);
+
+void catalogue_remove(SdBaseFile *dir, const char *name);
+
+// Marks an open file as printed just now, with the extent seen while
+// printing it.
+bool catalogue_printed(SdBaseFile *dir, SdBaseFile *file,
+                       int32_t min_x, int32_t min_y,
+                       int32_t max_x, int32_t max_y);
+
+// Brings the catalogue in line with the directory: records for files that
+// have gone or changed are dropped, and print files that aren't listed
+// yet are added without hashes or bounds. Returns the number of records.
+int16_t catalogue_rescan(SdBaseFile *dir);
+
+// Walks the records in order, skipping free slots.
+bool catalogue_open(SdBaseFile *dir, SdBaseFile *catalogue);
+bool catalogue_next(SdBaseFile *catalogue, JobRecord *record);
+
+#endif
@@ -26,7 +26,8 @@
 #include <Arduino.h>
 
 namespace Comms {
-    static const char *endl = "\r\n";
+    // A tag rather than a string, so it takes no RAM in each file using it
+    enum Endl { endl };
 }
 
 class SerialChannel {
@@ -42,6 +43,10 @@ public:
         Serial.print(arg);
     }
 
+    void send(Comms::Endl) {
+        Serial.println();
+    }
+
     template<class T> void println(const T arg) {
         send(arg);
         send(Comms::endl);
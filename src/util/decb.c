@@ -46,7 +46,7 @@ void decb_init()
 
 static int ishexdigit(char ch)
 {
-    return ch >= '0' && ch <= '9' || ch >= 'A' && ch <= 'F';
+    return (ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F');
 }
 
 int decb(char *inbuf, int *pinoff, int inlen, char *outbuf, int *poutlen)
@@ -125,7 +125,7 @@ int decb(char *inbuf, int *pinoff, int inlen, char *outbuf, int *poutlen)
                 return KEEP_GOING;
             if (firingLine == 0)
             {
-                if (lineLen > sizeof(lastFiringLine)-1)
+                if (lineLen > (int)sizeof(lastFiringLine)-1)
                 {
 #ifdef DEBUG
                     fprintf(stderr, "firing line too long %d > %d.\n", lineLen, (int)sizeof(lastFiringLine));
@@ -135,7 +135,7 @@ int decb(char *inbuf, int *pinoff, int inlen, char *outbuf, int *poutlen)
                 memcpy(lastFiringLine, line, lineLen);
                 lastFiringLine[lineLen] = 0;
             }
-            int firingLineLen = firingLine ? strlen(firingLine) : lineLen;
+            int firingLineLen = firingLine ? (int)strlen(firingLine) : lineLen;
             firingLine = firingLine ? firingLine : line;
             char *value = firingLine;
             int i;
@@ -0,0 +1,103 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "firing.h"
+
+#include <string.h>
+
+FiringQueue firing_queue;
+
+FiringQueue::FiringQueue() {
+    clear();
+}
+
+bool FiringQueue::add(uint32_t position, uint8_t rPrim, uint8_t address,
+        uint8_t lPrim) {
+    uint8_t slot = cartridge_address_slot(address);
+
+    if(slot >= CARTRIDGE_ADDRESSES) {
+        return false;
+    }
+
+    // Join the newest column if it is for the same position and this
+    // address hasn't been used in it yet.
+    if(!empty()) {
+        Column *column = &columns[(head - 1) & (capacity - 1)];
+
+        if(column->position == position
+                && !(column->prim[slot][0] | column->prim[slot][1])) {
+            column->prim[slot][0] = rPrim;
+            column->prim[slot][1] = lPrim;
+
+            return true;
+        }
+    }
+
+    if(full()) {
+        return false;
+    }
+
+    Column *column = &columns[head & (capacity - 1)];
+
+    column->position = position;
+    memset(column->prim, 0, sizeof(column->prim));
+    column->prim[slot][0] = rPrim;
+    column->prim[slot][1] = lPrim;
+
+    head++;
+
+    return true;
+}
+
+void FiringQueue::service(uint32_t position) {
+    while(head != tail) {
+        Column *column = &columns[tail & (capacity - 1)];
+
+        if(column->position != position) {
+            return;
+        }
+
+        fire_column(column->prim);
+
+        tail++;
+    }
+}
+
+void FiringQueue::clear(void) {
+    head = 0;
+    tail = 0;
+}
+
+bool FiringQueue::empty(void) {
+    return head == tail;
+}
+
+bool FiringQueue::full(void) {
+    return (uint8_t)(head - tail) == capacity;
+}
+
+uint8_t FiringQueue::count(void) {
+    return head - tail;
+}
+
+uint32_t FiringQueue::next_position(void) {
+    return columns[tail & (capacity - 1)].position;
+}
@@ -0,0 +1,80 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FIRING_H_
+#define _FIRING_H_
+
+#include <stdint.h>
+
+#include "cartridge.h"
+
+// Firings waiting for the head to reach a step position. Print playback
+// adds firings against the position at which they must happen and the axis
+// emits them from Axis::step() as the head passes, so the carriage never has
+// to stop to fire a column. Firings for the same position are gathered into
+// one column and fired together with fire_column().
+//
+// Build with FLY=0 to keep the queue out of Axis::step(); prints then stop
+// the head to fire, as the fly command turned off does.
+//
+//   make FLY=0
+
+#ifndef FLY
+#define FLY 1
+#endif
+
+class FiringQueue {
+public:
+    // Must be a power of two.
+    static const uint8_t capacity = 8;
+
+    FiringQueue();
+
+    // False if the queue is full, or the address is not part of a column.
+    bool add(uint32_t position, uint8_t rPrim, uint8_t address, uint8_t lPrim);
+
+    // Fires every queued column whose position is the given position.
+    void service(uint32_t position);
+
+    void clear(void);
+
+    bool empty(void);
+    bool full(void);
+    uint8_t count(void);
+
+    // Position of the next column, only valid if the queue is not empty.
+    uint32_t next_position(void);
+
+private:
+    struct Column {
+        uint32_t position;
+        uint8_t prim[CARTRIDGE_ADDRESSES][2];
+    };
+
+    Column columns[capacity];
+
+    uint8_t head;
+    uint8_t tail;
+};
+
+extern FiringQueue firing_queue;
+
+#endif
@@ -0,0 +1,75 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _HAL_H_
+#define _HAL_H_
+
+#include <stdint.h>
+
+// Hardware the firmware drives directly, below what the Arduino core
+// covers. Pins, time and serial go through the Arduino API as before;
+// everything here was register access on the ATmega2560.
+//
+// Each backend provides, as functions or macros:
+//
+// Cartridge ports
+//   hal_cartridge_initialise()          ports to outputs, all off
+//   hal_cartridge_address(address)      PORTC: [R1..R4, L1..L4]
+//   hal_cartridge_primitives(r, l)      PORTA (right) and PORTL (left)
+//   hal_cartridge_settle()              about 0.5us of address setup/hold
+//
+// Pulse timer, free running at HAL_TIMER_TICKS_PER_US
+//   hal_timer_initialise()
+//   hal_timer_ticks()                   16 bit count
+//   hal_timer_alarm(at)                 run HAL_TIMER_ALARM once at tick at
+//   hal_timer_alarm_cancel()            from inside the alarm handler
+//   HAL_TIMER_ALARM                     defines the alarm handler
+//
+// Cycle counter, for timing code to the CPU cycle
+//   hal_cycles_start()                  borrow a timer to count at F_CPU,
+//                                       returns the state to give back
+//   hal_cycles()                        16 bit count, wraps every 4ms
+//   hal_cycles_stop(state)
+//
+// Interrupts
+//   hal_irq_save(), hal_irq_restore(state)
+//   hal_poll()                          called from busy waits, so a backend
+//                                       without interrupts can deliver them
+//   hal_halt()                          stop for good, which ends the run
+//                                       under a simulator
+//
+// Limit switch inputs, raw levels before normally closed is applied
+//   hal_limit_x_positive(), hal_limit_x_negative()
+//   hal_limit_y_positive(), hal_limit_y_negative()
+//
+// EEPROM, HAL_EEPROM_SIZE bytes
+//   hal_eeprom_read(address), hal_eeprom_write(address, value)
+//
+// The SD card block device is Sd2Card from SdFat. On the AVR that is the
+// SPI driver in SdFat itself; other backends supply their own Sd2Card.
+
+#ifdef __AVR__
+#include "hal_avr.h"
+#else
+#include "hal_linux.h"
+#endif
+
+#endif
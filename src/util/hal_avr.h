@@ -0,0 +1,155 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _HAL_AVR_H_
+#define _HAL_AVR_H_
+
+// ATmega2560 backend of hal.h. All inline, so it compiles to the same
+// register accesses the firmware made before there was a HAL.
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <EEPROM.h>
+
+#define HAL_EEPROM_SIZE 4096
+
+// Timer1 runs at F_CPU / 8, half a microsecond per tick. This takes
+// Timer1 away from analogWrite() on pins 11 and 12, neither of which is used.
+#define HAL_TIMER_TICKS_PER_US 2
+
+#define HAL_TIMER_ALARM ISR(TIMER1_COMPA_vect)
+
+static inline void hal_cartridge_initialise(void) {
+    DDRC = 0xFF;
+    DDRL = 0xFF;
+    DDRA = 0xFF;
+}
+
+static inline void hal_cartridge_address(uint8_t address) {
+    PORTC = address;
+}
+
+static inline void hal_cartridge_primitives(uint8_t right, uint8_t left) {
+    PORTL = left;
+    PORTA = right;
+}
+
+static inline void hal_cartridge_settle(void) {
+    asm volatile("nop\n\t"
+                 "nop\n\t"
+                 "nop\n\t"
+                 "nop\n\t"
+                 "nop\n\t"
+                 "nop\n\t"
+                 "nop\n\t");
+}
+
+static inline void hal_timer_initialise(void) {
+    // Normal mode, prescaler 8
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11);
+    TCCR1C = 0;
+    TIMSK1 = 0;
+}
+
+static inline uint16_t hal_timer_ticks(void) {
+    return TCNT1;
+}
+
+static inline void hal_timer_alarm(uint16_t at) {
+    OCR1A = at;
+    TIFR1 = _BV(OCF1A);
+    TIMSK1 |= _BV(OCIE1A);
+}
+
+static inline void hal_timer_alarm_cancel(void) {
+    TIMSK1 &= ~_BV(OCIE1A);
+}
+
+// Timer3 normally runs the PWM on pins 2, 3 and 5 (the LED); while the
+// counter is borrowed it runs unprescaled with its outputs disconnected.
+static inline uint16_t hal_cycles_start(void) {
+    uint16_t state = (TCCR3A << 8) | TCCR3B;
+
+    TCCR3A = 0;
+    TCCR3B = _BV(CS30);
+
+    return state;
+}
+
+static inline uint16_t hal_cycles(void) {
+    return TCNT3;
+}
+
+static inline void hal_cycles_stop(uint16_t state) {
+    TCCR3B = 0;
+    TCNT3 = 0;
+    TCCR3A = state >> 8;
+    TCCR3B = state & 0xFF;
+}
+
+static inline uint8_t hal_irq_save(void) {
+    uint8_t sreg = SREG;
+    cli();
+    return sreg;
+}
+
+static inline void hal_irq_restore(uint8_t state) {
+    SREG = state;
+}
+
+static inline void hal_poll(void) {
+}
+
+// simavr quits when the CPU sleeps with interrupts off
+static inline void hal_halt(void) {
+    cli();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    sleep_cpu();
+}
+
+static inline bool hal_limit_x_positive(void) {
+    return PINE & 0b00001000;
+}
+
+static inline bool hal_limit_x_negative(void) {
+    return PINF & 0b00000001;
+}
+
+static inline bool hal_limit_y_positive(void) {
+    return PINF & 0b00000010;
+}
+
+static inline bool hal_limit_y_negative(void) {
+    return PINH & 0b00001000;
+}
+
+static inline uint8_t hal_eeprom_read(uint16_t address) {
+    return EEPROM.read(address);
+}
+
+static inline void hal_eeprom_write(uint16_t address, uint8_t value) {
+    EEPROM.write(address, value);
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _HAL_LINUX_H_
+#define _HAL_LINUX_H_
+
+// Linux backend of hal.h, for running the firmware as a native program.
+// The implementation is in host/hal_linux.cpp, along with the parts of the
+// Arduino core the firmware uses and an Sd2Card backed by an image file.
+
+#define HAL_EEPROM_SIZE 4096
+
+#define HAL_TIMER_TICKS_PER_US 2
+
+// No interrupts here, hal_poll() runs the alarm handler once it is due.
+#define HAL_TIMER_ALARM void hal_timer_alarm_handler(void)
+
+void hal_timer_alarm_handler(void);
+
+void hal_cartridge_initialise(void);
+void hal_cartridge_address(uint8_t address);
+void hal_cartridge_primitives(uint8_t right, uint8_t left);
+void hal_cartridge_settle(void);
+
+void hal_timer_initialise(void);
+uint16_t hal_timer_ticks(void);
+void hal_timer_alarm(uint16_t at);
+void hal_timer_alarm_cancel(void);
+
+uint16_t hal_cycles_start(void);
+uint16_t hal_cycles(void);
+void hal_cycles_stop(uint16_t state);
+
+uint8_t hal_irq_save(void);
+void hal_irq_restore(uint8_t state);
+void hal_poll(void);
+void hal_halt(void);
+
+bool hal_limit_x_positive(void);
+bool hal_limit_x_negative(void);
+bool hal_limit_y_positive(void);
+bool hal_limit_y_negative(void);
+
+uint8_t hal_eeprom_read(uint16_t address);
+void hal_eeprom_write(uint16_t address, uint8_t value);
+
+#endif
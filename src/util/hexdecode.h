@@ -0,0 +1,48 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _HEXDECODE_H_
+#define _HEXDECODE_H_
+
+#include <stdint.h>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_byte
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#endif
+#endif
+
+// Value of every character as a hex digit, 0 for anything that isn't one.
+extern const uint8_t hex_table[256] PROGMEM;
+
+#define hex_value(ch) pgm_read_byte(&hex_table[(uint8_t)(ch)])
+
+// Decodes the "aRRLL" part of a firing record: address, then right and left
+// primitives as two hex digits each.
+void hex_decode_spec(const char *spec, uint8_t *address, uint8_t *rPrim,
+        uint8_t *lPrim);
+
+#endif
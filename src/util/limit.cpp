@@ -22,6 +22,8 @@
 #include "limit.h"
 #include <Arduino.h>
 
+#include "hal.h"
+
 #include "../argentum/argentum.h"
 
 /*
@@ -77,33 +79,33 @@ uint8_t limit_switches(void) {
 
 bool limit_x_positive(void) {
     if(limit_switch_nc) {
-        return !(PINE & 0b00001000);
+        return !hal_limit_x_positive();
     } else {
-        return (PINE & 0b00001000);
+        return hal_limit_x_positive();
     }
 }
 
 bool limit_x_negative(void) {
     if(limit_switch_nc) {
-        return !(PINF & 0b00000001);
+        return !hal_limit_x_negative();
     } else {
-        return (PINF & 0b00000001);
+        return hal_limit_x_negative();
     }
 }
 
 bool limit_y_positive(void) {
     if(limit_switch_nc) {
-        return !(PINF & 0b00000010);
+        return !hal_limit_y_positive();
     } else {
-        return (PINF & 0b00000010);
+        return hal_limit_y_positive();
     }
 }
 
 bool limit_y_negative(void) {
     if(limit_switch_nc) {
-        return !(PINH & 0b00001000);
+        return !hal_limit_y_negative();
     } else {
-        return (PINH & 0b00001000);
+        return hal_limit_y_negative();
     }
 }
 
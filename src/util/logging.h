@@ -27,39 +27,49 @@
 
 #include "comms.h"
 
+// Levels below LOG_LEVEL are left out at compile time: the wrapper for them
+// streams nothing, so those statements produce no code and their strings
+// take no flash. 0 debug, 1 info, 2 warn, 3 error. Debug is for logging in
+// the motion and firing paths, which only a debug build can afford:
+//   make LOG_LEVEL=0
+// Levels that are built in can still be muted with minimum_log_level.
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL 1
+#endif
+
 // Because the definition comes after
-class LoggerWrapper;
+template<uint8_t Level> class LoggerWrapper;
 
 class Logger {
 public:
     enum LogLevels {
-        Info  = 0,
-        Warn  = 1,
-        Error = 2
+        Debug = 0,
+        Info  = 1,
+        Warn  = 2,
+        Error = 3
     };
 
-    static const char *level_prefixes[];
+    static const char level_prefixes[][2];
 
     Logger();
     ~Logger();
 
-    LoggerWrapper & info(void);
+    inline LoggerWrapper<Debug> & debug(void);
 
-    template<class T> inline LoggerWrapper & info(T arg) {
-        return info() << arg << Comms::endl;
-    }
+    template<class T> inline LoggerWrapper<Debug> & debug(T arg);
 
-    LoggerWrapper & warn(void);
+    inline LoggerWrapper<Info> & info(void);
 
-    template<class T> inline LoggerWrapper & warn(T arg) {
-        return warn() << arg << Comms::endl;
-    }
+    template<class T> inline LoggerWrapper<Info> & info(T arg);
 
-    LoggerWrapper & error(void);
+    inline LoggerWrapper<Warn> & warn(void);
 
-    template<class T> inline LoggerWrapper & error(T arg) {
-        return error() << arg << Comms::endl;
-    }
+    template<class T> inline LoggerWrapper<Warn> & warn(T arg);
+
+    inline LoggerWrapper<Error> & error(void);
+
+    template<class T> inline LoggerWrapper<Error> & error(T arg);
 
     uint8_t minimum_log_level;
     bool enabled;
@@ -73,25 +83,68 @@ private:
 
     void emit_prefix_for_level(uint8_t level);
 
-    friend class LoggerWrapper;
+    template<uint8_t Level> inline LoggerWrapper<Level> & start(void);
+
+    template<uint8_t Level> friend class LoggerWrapper;
 };
 
-class LoggerWrapper {
-public:
-    LoggerWrapper(Logger *logger, uint8_t log_level);
-    ~LoggerWrapper();
+extern Logger logger;
 
+// Holds nothing, the level is in the type. The test on Level is a constant
+// and the compiler drops the call for levels that aren't built in.
+template<uint8_t Level> class LoggerWrapper {
+public:
     template<class T> inline LoggerWrapper &operator <<(T arg) {
-        logger->log_for_level(arg, log_level);
+        if(Level >= LOG_LEVEL) {
+            logger.log_for_level(arg, Level);
+        }
 
         return *this;
     }
 
-private:
-    Logger *logger;
-    uint8_t log_level;
+    static LoggerWrapper wrapper;
 };
 
-extern Logger logger;
+template<uint8_t Level> LoggerWrapper<Level> LoggerWrapper<Level>::wrapper;
+
+template<uint8_t Level> inline LoggerWrapper<Level> & Logger::start(void) {
+    if(Level >= LOG_LEVEL) {
+        emit_prefix_for_level(Level);
+    }
+
+    return LoggerWrapper<Level>::wrapper;
+}
+
+inline LoggerWrapper<Logger::Debug> & Logger::debug(void) {
+    return start<Debug>();
+}
+
+template<class T> inline LoggerWrapper<Logger::Debug> & Logger::debug(T arg) {
+    return debug() << arg << Comms::endl;
+}
+
+inline LoggerWrapper<Logger::Info> & Logger::info(void) {
+    return start<Info>();
+}
+
+template<class T> inline LoggerWrapper<Logger::Info> & Logger::info(T arg) {
+    return info() << arg << Comms::endl;
+}
+
+inline LoggerWrapper<Logger::Warn> & Logger::warn(void) {
+    return start<Warn>();
+}
+
+template<class T> inline LoggerWrapper<Logger::Warn> & Logger::warn(T arg) {
+    return warn() << arg << Comms::endl;
+}
+
+inline LoggerWrapper<Logger::Error> & Logger::error(void) {
+    return start<Error>();
+}
+
+template<class T> inline LoggerWrapper<Logger::Error> & Logger::error(T arg) {
+    return error() << arg << Comms::endl;
+}
 
 #endif
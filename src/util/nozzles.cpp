@@ -0,0 +1,95 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "nozzles.h"
+#include "settings.h"
+
+uint8_t nozzle_pending[2][CARTRIDGE_ADDRESSES][NOZZLES_PRIMITIVES];
+bool nozzle_flush_needed = false;
+
+static uint16_t total_address(uint8_t side, uint8_t slot, uint8_t primitive) {
+    uint16_t index = (side * CARTRIDGE_ADDRESSES + slot) * NOZZLES_PRIMITIVES
+            + primitive;
+
+    return NOZZLES_ADDRESS + sizeof(uint16_t) + index * sizeof(uint32_t);
+}
+
+void nozzles_initialise(void) {
+    uint16_t magic;
+
+    memset(nozzle_pending, 0, sizeof(nozzle_pending));
+
+    read_block(NOZZLES_ADDRESS, &magic, sizeof(magic));
+
+    if(magic != NOZZLES_MAGIC) {
+        // Fresh EEPROM
+        nozzles_reset(NOZZLES_RIGHT);
+        nozzles_reset(NOZZLES_LEFT);
+
+        magic = NOZZLES_MAGIC;
+        write_block(NOZZLES_ADDRESS, &magic, sizeof(magic));
+    }
+}
+
+void nozzles_flush(void) {
+    for(uint8_t side = 0; side < 2; side++) {
+        for(uint8_t slot = 0; slot < CARTRIDGE_ADDRESSES; slot++) {
+            for(uint8_t primitive = 0; primitive < NOZZLES_PRIMITIVES; primitive++) {
+                uint8_t pending = nozzle_pending[side][slot][primitive];
+
+                if(pending == 0) {
+                    continue;
+                }
+
+                uint16_t address = total_address(side, slot, primitive);
+                uint32_t total;
+
+                read_block(address, &total, sizeof(total));
+                total += pending;
+                write_block(address, &total, sizeof(total));
+
+                nozzle_pending[side][slot][primitive] = 0;
+            }
+        }
+    }
+
+    nozzle_flush_needed = false;
+}
+
+void nozzles_reset(uint8_t side) {
+    uint32_t zero = 0;
+
+    for(uint8_t slot = 0; slot < CARTRIDGE_ADDRESSES; slot++) {
+        for(uint8_t primitive = 0; primitive < NOZZLES_PRIMITIVES; primitive++) {
+            write_block(total_address(side, slot, primitive), &zero,
+                    sizeof(zero));
+            nozzle_pending[side][slot][primitive] = 0;
+        }
+    }
+}
+
+uint32_t nozzles_total(uint8_t side, uint8_t slot, uint8_t primitive) {
+    uint32_t total;
+
+    read_block(total_address(side, slot, primitive), &total, sizeof(total));
+
+    return total + nozzle_pending[side][slot][primitive];
+}
@@ -0,0 +1,79 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _NOZZLES_H_
+#define _NOZZLES_H_
+
+#include <Arduino.h>
+
+#include "cartridge.h"
+
+// Lifetime firing counts for every nozzle, right and left cartridge, per
+// column slot and primitive. Counts build up in RAM, a byte each, and are
+// added to the totals in EEPROM by nozzles_flush(). Only the bytes of a
+// total that change are rewritten, mostly just the low one.
+const uint16_t NOZZLES_ADDRESS = 512;
+const uint16_t NOZZLES_MAGIC = 0x4E5A;
+
+#define NOZZLES_RIGHT      0
+#define NOZZLES_LEFT       1
+#define NOZZLES_PRIMITIVES 8
+
+// Pending counts are flushed before they can overflow. Past the threshold
+// there is room for the 8 columns the firing queue can still hold.
+#define NOZZLES_FLUSH_THRESHOLD 0xF0
+
+extern uint8_t nozzle_pending[2][CARTRIDGE_ADDRESSES][NOZZLES_PRIMITIVES];
+extern bool nozzle_flush_needed;
+
+void nozzles_initialise(void);
+void nozzles_flush(void);
+void nozzles_reset(uint8_t side);
+
+uint32_t nozzles_total(uint8_t side, uint8_t slot, uint8_t primitive);
+
+static inline void nozzles_count_side(uint8_t *counts, uint8_t prim) {
+    while(prim) {
+        if(prim & 0x01) {
+            if(++(*counts) >= NOZZLES_FLUSH_THRESHOLD) {
+                nozzle_flush_needed = true;
+            }
+        }
+
+        counts++;
+        prim >>= 1;
+    }
+}
+
+static inline void nozzles_count(uint8_t slot, uint8_t rPrim, uint8_t lPrim) {
+    nozzles_count_side(nozzle_pending[NOZZLES_RIGHT][slot], rPrim);
+    nozzles_count_side(nozzle_pending[NOZZLES_LEFT][slot], lPrim);
+}
+
+// Writing EEPROM takes milliseconds, so the firing code only raises the flag
+// and whoever called it flushes once the head can wait.
+static inline void nozzles_flush_if_needed(void) {
+    if(nozzle_flush_needed) {
+        nozzles_flush();
+    }
+}
+
+#endif
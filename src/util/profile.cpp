@@ -0,0 +1,184 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "profile.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "comms.h"
+#include "logging.h"
+#include "telemetry.h"
+
+#if PROFILE
+
+static ProfileStats stats[PROFILE_STAGES];
+static uint32_t loop_untimed = 0;
+
+static const char stage_names[PROFILE_STAGES][8] PROGMEM = {
+    "Loop", "Step", "SD read", "Parse", "Fire"
+};
+
+static void profile_add(ProfileStats *stage, uint16_t ticks) {
+    if(stage->count == 0 || ticks < stage->min) {
+        stage->min = ticks;
+    }
+
+    if(ticks > stage->max) {
+        stage->max = ticks;
+    }
+
+    stage->count++;
+    stage->total += ticks;
+
+    uint8_t bucket = 0;
+
+    while(ticks >>= 1) {
+        bucket++;
+    }
+
+    if(stage->buckets[bucket] != 0xFFFF) {
+        stage->buckets[bucket]++;
+    }
+}
+
+void profile_loop(void) {
+    static bool started = false;
+    static uint16_t last_ticks;
+    static uint16_t last_ms;
+
+    uint16_t now = hal_timer_ticks();
+    uint16_t ms = millis();
+
+    if(started) {
+        // Too long for the timer to have measured
+        if((uint16_t)(ms - last_ms) >= 30) {
+            loop_untimed++;
+        } else {
+            profile_add(&stats[PROFILE_LOOP], now - last_ticks);
+        }
+    }
+
+    started = true;
+    last_ticks = now;
+    last_ms = ms;
+}
+
+void profile_reset(void) {
+    memset(stats, 0, sizeof(stats));
+    loop_untimed = 0;
+}
+
+uint16_t profile_bytes(void) {
+    return sizeof(stats);
+}
+
+// Ticks as microseconds, to the half
+static void print_ticks(uint32_t ticks) {
+    Serial.print(ticks / HAL_TIMER_TICKS_PER_US);
+
+    if(ticks % HAL_TIMER_TICKS_PER_US) {
+        Serial.print(F(".5"));
+    }
+}
+
+void profile_print(void) {
+    logger.info() << F("Times in us: count, min/avg/max") << Comms::endl;
+
+    for(uint8_t i = 0; i < PROFILE_STAGES; i++) {
+        ProfileStats *stage = &stats[i];
+
+        Serial.print((const __FlashStringHelper *)stage_names[i]);
+        Serial.print(F(": "));
+        Serial.print(stage->count);
+
+        if(stage->count) {
+            Serial.print(F(", "));
+            print_ticks(stage->min);
+            Serial.print('/');
+            print_ticks(stage->total / stage->count);
+            Serial.print('/');
+            print_ticks(stage->max);
+        }
+
+        if(i == PROFILE_LOOP && loop_untimed) {
+            Serial.print(F(", "));
+            Serial.print(loop_untimed);
+            Serial.print(F(" over 30 ms"));
+        }
+
+        Serial.println();
+
+        // Bucket b holds samples of 2^b up to 2^(b+1) ticks
+        for(uint8_t b = 0; b < PROFILE_BUCKETS; b++) {
+            if(stage->buckets[b] == 0) {
+                continue;
+            }
+
+            Serial.print(F("  < "));
+            print_ticks(2UL << b);
+            Serial.print(F(": "));
+            Serial.println(stage->buckets[b]);
+        }
+    }
+}
+
+#else
+
+void profile_reset(void) {
+}
+
+uint16_t profile_bytes(void) {
+    return 0;
+}
+
+void profile_print(void) {
+    logger.info(F("Built without PROFILE"));
+}
+
+#endif
+
+#if PROFILE || TELEMETRY
+
+// Every stage sample, for the statistics and the job telemetry
+void profile_end(uint8_t stage, uint16_t start) {
+    uint16_t ticks = hal_timer_ticks() - start;
+
+#if TELEMETRY
+    switch(stage) {
+        case PROFILE_SD_READ:
+            time_total_add(&telemetry.sd, ticks / HAL_TIMER_TICKS_PER_US);
+            break;
+        case PROFILE_PARSE:
+            telemetry.records++;
+            break;
+        case PROFILE_FIRE:
+            time_total_add(&telemetry.firing, ticks / HAL_TIMER_TICKS_PER_US);
+            break;
+    }
+#endif
+
+#if PROFILE
+    profile_add(&stats[stage], ticks);
+#endif
+}
+
+#endif
@@ -0,0 +1,103 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+#include <stdint.h>
+
+#include "hal.h"
+#include "telemetry.h"
+
+// Where the time goes on the board. Each stage is timed on the pulse timer
+// and gathered into min/avg/max and a histogram with a bucket per power of
+// two; prof prints them. A sample is at most one timer period, 32 ms.
+// The stage times also go to the job telemetry.
+//
+// Build with PROFILE=0 to leave the profiler out. The stages are still
+// timed for the telemetry unless that is left out too, in which case
+// profile_begin() and profile_end() are empty inlines and the hot paths
+// pay nothing.
+//
+//   make PROFILE=0 TELEMETRY=0
+
+#ifndef PROFILE
+#define PROFILE 1
+#endif
+
+enum ProfileStage {
+    PROFILE_LOOP,       // one pass of loop() to the next
+    PROFILE_STEP,       // a step, with its firings
+    PROFILE_SD_READ,    // a block from the card
+    PROFILE_PARSE,      // reading and decoding one line of a job
+    PROFILE_FIRE,       // fire_head() or a queued column, with the waits
+                        // for recovery
+    PROFILE_STAGES
+};
+
+#define PROFILE_BUCKETS 16
+
+struct ProfileStats {
+    uint32_t count;
+    uint32_t total;
+    uint16_t min;
+    uint16_t max;
+    uint16_t buckets[PROFILE_BUCKETS];
+};
+
+#if PROFILE || TELEMETRY
+
+static inline uint16_t profile_begin(void) {
+    return hal_timer_ticks();
+}
+
+void profile_end(uint8_t stage, uint16_t start);
+
+#else
+
+static inline uint16_t profile_begin(void) {
+    return 0;
+}
+
+static inline void profile_end(uint8_t /*stage*/, uint16_t /*start*/) {
+}
+
+#endif
+
+#if PROFILE
+
+// Called at the top of loop(), times the whole pass including serialEvent.
+// Passes that ran a long command are counted but not timed.
+void profile_loop(void);
+
+#else
+
+static inline void profile_loop(void) {
+}
+
+#endif
+
+void profile_reset(void);
+void profile_print(void);
+
+uint16_t profile_bytes(void);
+
+#endif
@@ -56,33 +56,33 @@ unsigned char Rollers::getangle(void)
 }
 
 void Rollers::angle(unsigned char angle) {
-    // logger.info("Changing servo angle.");
-    if(angle >= 0 && angle <= 180)
+    logger.debug(F("Changing servo angle."));
+    if(angle <= 180)
     {
       roller_servo.write(angle);
-      logger.info("Servo angle changed to:");
+      logger.info(F("Servo angle changed to:"));
       logger.info(angle);
     }
     else
-      logger.info("Invalide servo angle.");
+      logger.info(F("Invalide servo angle."));
 }
 
 // Set the retract position to angle.
 void Rollers::setrp(unsigned char angle)
 {
-    if(angle >= 0 && angle <= 180)
+    if(angle <= 180)
       global_settings.rollerOptions.retracted_pos = angle;
     else
-      logger.info("Invalide servo angle.");
+      logger.info(F("Invalide servo angle."));
 }
 
 // Set the deploy position to angle.
 void Rollers::setdp(unsigned char angle)
 {
-    if(angle >= 0 && angle <= 180)
+    if(angle <= 180)
         global_settings.rollerOptions.deployed_pos = angle;
     else
-      logger.info("Invalide servo angle.");
+      logger.info(F("Invalide servo angle."));
 }
 
 unsigned int Rollers::width_with_overlap(double overlap) {
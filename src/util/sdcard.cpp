@@ -0,0 +1,192 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdcard.h"
+
+#include <util/crc16.h>
+
+#include "settings.h"
+#include "logging.h"
+
+static uint8_t current_divisor = 0;
+
+static bool sdcard_valid_divisor(uint8_t divisor) {
+    return divisor == SPI_FULL_SPEED ||
+           divisor == SPI_HALF_SPEED ||
+           divisor == SPI_QUARTER_SPEED;
+}
+
+// Saves the divisor alone. The RAM settings may hold edits nobody saved, or
+// the defaults after a CRC failure, so they aren't written out with it, and
+// stored settings that don't check out are left for the user to deal with.
+static void sdcard_remember(uint8_t divisor) {
+    current_divisor = divisor;
+
+    global_settings.sd_spi_divisor = divisor;
+    settings_update_crc();
+
+    PrinterSettings stored;
+    settings_read_settings(&stored);
+
+    if(!settings_integrity_check(&stored) || stored.sd_spi_divisor == divisor) {
+        return;
+    }
+
+    PrinterSettings existing = stored;
+
+    stored.sd_spi_divisor = divisor;
+    stored.crc = settings_calculate_crc(&stored);
+
+    replace_block(SETTINGS_ADDRESS, &stored, &existing, sizeof(stored));
+}
+
+// CRC16 of each probe block: the boot sector, the start of the first FAT
+// and the start of the data area, so a mix of empty and busy blocks.
+static bool sdcard_read_crcs(SdFat *sd, uint16_t crcs[SDCARD_PROBE_BLOCKS]) {
+    SdVolume *vol = sd->vol();
+
+    // The volume cache is free to use as scratch once it has been flushed.
+    cache_t *scratch = vol->cacheClear();
+
+    if(!scratch) {
+        return false;
+    }
+
+    for(uint8_t i = 0; i < SDCARD_PROBE_BLOCKS; i++) {
+        uint32_t block;
+
+        if(i == 0) {
+            block = 0;
+        } else if(i < SDCARD_PROBE_BLOCKS / 2) {
+            block = vol->fatStartBlock() + i - 1;
+        } else {
+            block = vol->dataStartBlock() + i - SDCARD_PROBE_BLOCKS / 2;
+        }
+
+        if(!sd->card()->readBlock(block, scratch->data)) {
+            return false;
+        }
+
+        uint16_t crc = 0xFFFF;
+
+        for(uint16_t j = 0; j < 512; j++) {
+            crc = _crc_ccitt_update(crc, scratch->data[j]);
+        }
+
+        crcs[i] = crc;
+    }
+
+    return true;
+}
+
+static bool sdcard_verify(SdFat *sd, uint16_t reference[SDCARD_PROBE_BLOCKS]) {
+    uint16_t crcs[SDCARD_PROBE_BLOCKS];
+
+    for(uint8_t pass = 0; pass < SDCARD_PROBE_PASSES; pass++) {
+        if(!sdcard_read_crcs(sd, crcs)) {
+            return false;
+        }
+
+        if(memcmp(crcs, reference, sizeof(crcs)) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool sdcard_initialise(SdFat *sd, uint8_t chip_select) {
+    uint8_t divisor = global_settings.sd_spi_divisor;
+
+    if(sdcard_valid_divisor(divisor) && sd->begin(chip_select, divisor)) {
+        current_divisor = divisor;
+        return true;
+    }
+
+    return sdcard_probe(sd, chip_select);
+}
+
+bool sdcard_probe(SdFat *sd, uint8_t chip_select) {
+    uint16_t reference[SDCARD_PROBE_BLOCKS];
+
+    current_divisor = 0;
+
+    // Half speed is what every printer has run at so far, so its reads are
+    // taken as correct. A card that can't manage that gets one more try at
+    // quarter speed without any checking.
+    if(!sd->begin(chip_select, SPI_HALF_SPEED) ||
+            !sdcard_read_crcs(sd, reference)) {
+        if(!sd->begin(chip_select, SPI_QUARTER_SPEED)) {
+            return false;
+        }
+
+        sdcard_remember(SPI_QUARTER_SPEED);
+        return true;
+    }
+
+    if(sd->begin(chip_select, SPI_FULL_SPEED) && sdcard_verify(sd, reference)) {
+        sdcard_remember(SPI_FULL_SPEED);
+        return true;
+    }
+
+    if(!sd->begin(chip_select, SPI_HALF_SPEED)) {
+        return false;
+    }
+
+    sdcard_remember(SPI_HALF_SPEED);
+    return true;
+}
+
+uint8_t sdcard_divisor(void) {
+    return current_divisor;
+}
+
+static void sdcard_print_rate(const __FlashStringHelper *name, uint32_t hits,
+        uint32_t misses) {
+    uint32_t total = hits + misses;
+
+    logger.info() << name << hits << F(" hits, ") << misses << F(" misses, ")
+            << (total ? hits * 100 / total : 0) << F("%") << Comms::endl;
+}
+
+void sdcard_print_cache_stats(void) {
+    SdVolume::CacheStats *stats = &SdVolume::cacheStats;
+
+    sdcard_print_rate(F("SD cache data: "), stats->hits, stats->misses);
+    sdcard_print_rate(F("SD cache FAT:  "), stats->fatHits, stats->fatMisses);
+    logger.info() << F("SD streamed:   ") << stats->streamed
+            << F(" blocks, not through the cache") << Comms::endl;
+}
+
+void sdcard_reset_cache_stats(void) {
+    memset(&SdVolume::cacheStats, 0, sizeof(SdVolume::CacheStats));
+}
+
+uint16_t sdcard_cache_bytes(void) {
+#if USE_MULTIPLE_CARDS
+    // The cache lives inside each SdVolume and is counted with it.
+    return 0;
+#elif USE_SEPARATE_FAT_CACHE
+    return 2 * sizeof(cache_t);
+#else
+    return SD_CACHE_BLOCKS * sizeof(cache_t);
+#endif
+}
@@ -0,0 +1,55 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SDCARD_H_
+#define _SDCARD_H_
+
+#include <Arduino.h>
+
+#include "SdFat/SdFat.h"
+
+// Number of blocks read back when checking a clock speed, and how many
+// times they are read at that speed.
+#define SDCARD_PROBE_BLOCKS 8
+#define SDCARD_PROBE_PASSES 4
+
+// Bring up the card at the SPI speed remembered in settings. If nothing is
+// remembered, or the card no longer starts at that speed, probe again.
+bool sdcard_initialise(SdFat *sd, uint8_t chip_select);
+
+// Try SPI_FULL_SPEED and keep it only if repeated reads of a handful of
+// blocks match a reference read taken at SPI_HALF_SPEED. The speed that
+// works is stored in settings.
+bool sdcard_probe(SdFat *sd, uint8_t chip_select);
+
+// SCK divisor in use, 0 if the card has not been initialised.
+uint8_t sdcard_divisor(void);
+
+// Volume cache hit rates since the last reset. Print playback streams its
+// data blocks around the cache, so those are counted apart, and during a
+// print the hit rates are mostly FAT and directory blocks.
+void sdcard_print_cache_stats(void);
+void sdcard_reset_cache_stats(void);
+
+// Bytes of static RAM held by the volume block cache.
+uint16_t sdcard_cache_bytes(void);
+
+#endif
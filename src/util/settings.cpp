@@ -21,8 +21,9 @@
 
 #include "settings.h"
 
-#include <EEPROM.h>
+#include <stddef.h>
 #include "utils.h"
+#include "hal.h"
 
 PrinterSettings default_settings = {
     {
@@ -47,6 +48,7 @@ PrinterSettings default_settings = {
         70,
         80
     },
+    0,
     0x23
 };
 
@@ -59,8 +61,14 @@ bool settings_initialise() {
 
     bool valid = settings_integrity_check(&global_settings);
 
+    if (!valid && settings_migrate(&global_settings)) {
+        Serial.println(F("Settings upgraded."));
+        settings_write_settings(&global_settings);
+        valid = true;
+    }
+
     if (!valid) {
-        Serial.println("Settings corrupt.");
+        Serial.println(F("Settings corrupt."));
         settings_restore_defaults();
     }
 
@@ -68,7 +76,7 @@ bool settings_initialise() {
 }
 
 void settings_restore_defaults(void) {
-    Serial.println("Restoring default settings.");
+    Serial.println(F("Restoring default settings."));
     settings_update_settings(&default_settings);
 }
 
@@ -77,51 +85,52 @@ void settings_print_settings(PrinterSettings *settings) {
     settings_print_processing_options(&(settings->processingOptions));
     settings_print_printer_number(settings->printerNumber);
     settings_print_roller_options(&(settings->rollerOptions));
+    settings_print_sd_spi_divisor(settings->sd_spi_divisor);
 
     uint8_t crc = settings_calculate_crc(settings);
 
-    Serial.print("CRC: ");
+    Serial.print(F("CRC: "));
     Serial.print(settings->crc, HEX);
-    Serial.print(", Calculated: ");
+    Serial.print(F(", Calculated: "));
     Serial.print(crc, HEX);
 
     if(crc == settings->crc) {
-        Serial.println(" [GOOD]");
+        Serial.println(F(" [GOOD]"));
     } else {
-        Serial.println(" [CORRUPT]");
+        Serial.println(F(" [CORRUPT]"));
     }
 }
 
 void settings_print_calibration(CalibrationData *calibration) {
-    Serial.print("X axis: ");
+    Serial.print(F("X axis: "));
     settings_print_axis_data(&(calibration->x_axis));
 
-    Serial.print("Y axis: ");
+    Serial.print(F("Y axis: "));
     settings_print_axis_data(&(calibration->y_axis));
 }
 
 void settings_print_axis_data(AxisData *axis) {
     Serial.print((char)axis->motor);
-    Serial.print(" motor, ");
+    Serial.print(F(" motor, "));
 
     if(axis->flipped) {
-        Serial.print("flipped, ");
+        Serial.print(F("flipped, "));
     } else {
-        Serial.print("not flipped, ");
+        Serial.print(F("not flipped, "));
     }
 
     Serial.print(axis->length);
-    Serial.println(" steps");
+    Serial.println(F(" steps"));
 }
 
 void settings_print_axis_data_minimal(AxisData *axis) {
     Serial.print((char)axis->motor);
-    /*Serial.print(", ");
+    /*Serial.print(F(", "));
 
     if(axis->flipped) {
-        Serial.print("!, ");
+        Serial.print(F("!, "));
     } else {
-        Serial.print(" , ");
+        Serial.print(F(" , "));
     }*/
 
     Serial.print(axis->length);
@@ -129,28 +138,39 @@ void settings_print_axis_data_minimal(AxisData *axis) {
 }
 
 void settings_print_processing_options(ProcessingOptionsData *processingOptions) {
-    Serial.print("horizontal_offset: ");
+    Serial.print(F("horizontal_offset: "));
     Serial.println(processingOptions->horizontal_offset);
-    Serial.print("vertical_offset: ");
+    Serial.print(F("vertical_offset: "));
     Serial.println(processingOptions->vertical_offset);
-    Serial.print("print_overlap: ");
+    Serial.print(F("print_overlap: "));
     Serial.println(processingOptions->print_overlap);
 }
 
 void settings_print_printer_number(char *printerNumber)
 {
-    Serial.print("printerNumber: ");
+    Serial.print(F("printerNumber: "));
     Serial.println(printerNumber);
 }
 
 void settings_print_roller_options(RollerOptionsData *rollerOptions)
 {
-    Serial.print("retracted_pos: ");
+    Serial.print(F("retracted_pos: "));
     Serial.println(rollerOptions->retracted_pos);
-    Serial.print("deployed_pos: ");
+    Serial.print(F("deployed_pos: "));
     Serial.println(rollerOptions->deployed_pos);
 }
 
+void settings_print_sd_spi_divisor(uint8_t divisor)
+{
+    Serial.print(F("sd_spi_divisor: "));
+
+    if(divisor) {
+        Serial.println(divisor);
+    } else {
+        Serial.println(F("not probed"));
+    }
+}
+
 // Settings CRC Utilities
 
 uint8_t settings_calculate_crc(PrinterSettings *settings) {
@@ -167,6 +187,22 @@ bool settings_integrity_check(PrinterSettings *settings) {
     return (crc == settings->crc);
 }
 
+// Settings written before sd_spi_divisor was added are one byte shorter, so
+// their CRC sits where sd_spi_divisor is now. Recognise that layout and
+// carry the old values over rather than restoring defaults.
+bool settings_migrate(PrinterSettings *settings) {
+    uint16_t legacy_size = offsetof(PrinterSettings, sd_spi_divisor);
+
+    if(CRC8(settings, legacy_size) != settings->sd_spi_divisor) {
+        return false;
+    }
+
+    settings->sd_spi_divisor = 0;
+    settings->crc = settings_calculate_crc(settings);
+
+    return true;
+}
+
 // Settings Read and Write
 
 void settings_read_settings(PrinterSettings *settings) {
@@ -220,7 +256,7 @@ void settings_update_crc(void) {
 // Base EEPROM Functions
 
 uint8_t read_byte(const uint16_t address) {
-    return EEPROM.read(address);
+    return hal_eeprom_read(address);
 }
 
 void write_byte(const uint16_t address, const uint8_t value, bool reduce_wear) {
@@ -232,7 +268,7 @@ void write_byte(const uint16_t address, const uint8_t value, bool reduce_wear) {
         }
     }
 
-    EEPROM.write(address, value);
+    hal_eeprom_write(address, value);
 }
 
 void read_block(const uint16_t address, void *buffer, const uint16_t length) {
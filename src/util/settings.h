@@ -56,6 +56,7 @@ struct PrinterSettings {
     ProcessingOptionsData processingOptions;
     char printerNumber[20];
     RollerOptionsData rollerOptions;
+    uint8_t sd_spi_divisor;     // 0 until the SD card speed has been probed
     uint8_t crc;
 };
 
@@ -74,9 +75,11 @@ void settings_print_axis_data_minimal(AxisData *axis);
 void settings_print_processing_options(ProcessingOptionsData *processingOptions);
 void settings_print_printer_number(char *printerNumber);
 void settings_print_roller_options(RollerOptionsData *rollerOptions);
+void settings_print_sd_spi_divisor(uint8_t divisor);
 
 uint8_t settings_calculate_crc(PrinterSettings *settings);
 bool settings_integrity_check(PrinterSettings *settings);
+bool settings_migrate(PrinterSettings *settings);
 
 void settings_read_settings(PrinterSettings *settings);
 void settings_write_settings(PrinterSettings *settings);
@@ -30,6 +30,7 @@ Stepper::Stepper(int step_pin, int dir_pin, int enable_pin) {
     this->enable_pin = enable_pin;
 
     this->last_step_time = 0;
+    this->last_interval = 0;
 
     /* Speed is the delay between steps necessary to move at the required speed
      * The default speed is 500. To move instantaneously, set speed to 0 (this
@@ -78,11 +79,14 @@ uint8_t Stepper::get_direction(void) {
 }
 
 bool Stepper::step() {
-    if((micros() - last_step_time) > step_delay) {
+    unsigned long interval = micros() - last_step_time;
+
+    if(interval > (unsigned long)step_delay) {
         digitalWrite(step_pin, HIGH);
         digitalWrite(step_pin, LOW);
 
         last_step_time = micros();
+        last_interval = interval;
 
         return true;
     }
@@ -106,3 +110,11 @@ void Stepper::set_speed(int mm_per_minute) {
 int Stepper::get_speed() {
     return 0; //speed;
 }
+
+int Stepper::get_step_delay(void) {
+    return step_delay;
+}
+
+unsigned long Stepper::get_last_interval(void) {
+    return last_interval;
+}
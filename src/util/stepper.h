@@ -44,6 +44,10 @@ public:
     void set_speed(int mm_per_minute); //set to 0 for instantaneous movement
     int  get_speed();
 
+    // Microseconds wanted between steps, and what it was up to the last one
+    int get_step_delay(void);
+    unsigned long get_last_interval(void);
+
     static const long steps_per_mm = 80;
 
 private:
@@ -52,6 +56,7 @@ private:
     int enable_pin;
 
     long last_step_time;
+    unsigned long last_interval;
     int direction;
     int step_delay;
 };
@@ -0,0 +1,88 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "telemetry.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+#if TELEMETRY
+
+JobTelemetry telemetry;
+
+void time_total_add(TimeTotal *total, uint32_t us) {
+    us += total->us;
+
+    total->ms += us / 1000;
+    total->us = us % 1000;
+}
+
+void telemetry_start(void) {
+    memset(&telemetry, 0, sizeof(telemetry));
+    telemetry.start_ms = millis();
+}
+
+void telemetry_step(uint32_t interval_us, bool continuing) {
+    telemetry.steps++;
+
+    if(continuing) {
+        time_total_add(&telemetry.moving, interval_us);
+    }
+}
+
+// count per second over ms, in 32 bits for counts up to 400 million
+static uint32_t per_second(uint32_t count, uint32_t ms) {
+    return ms >= 100 ? count * 10 / (ms / 100) : 0;
+}
+
+static void print_field(const __FlashStringHelper *name, uint32_t value) {
+    Serial.print(' ');
+    Serial.print(name);
+    Serial.print('=');
+    Serial.print(value);
+}
+
+void telemetry_report(const char *job, uint32_t bytes, uint32_t late_steps) {
+    uint32_t wall = millis() - telemetry.start_ms;
+
+    telemetry.bytes = bytes;
+
+    Serial.print(F("telemetry job="));
+    Serial.print(job);
+    print_field(F("wall_ms"), wall);
+    print_field(F("moving_ms"), telemetry.moving.ms);
+    print_field(F("firing_ms"), telemetry.firing.ms);
+    print_field(F("sd_ms"), telemetry.sd.ms);
+    print_field(F("serial_ms"), telemetry.serial.ms);
+    print_field(F("bytes"), telemetry.bytes);
+    print_field(F("records"), telemetry.records);
+    print_field(F("firings"), telemetry.firings);
+    print_field(F("firings_per_s"), per_second(telemetry.firings, wall));
+    print_field(F("steps"), telemetry.steps);
+    print_field(F("steps_per_s"), per_second(telemetry.steps,
+            telemetry.moving.ms));
+    print_field(F("late_steps"), late_steps);
+    print_field(F("underruns"), telemetry.underruns);
+    print_field(F("brownouts"), telemetry.brownouts);
+    Serial.println();
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include <stdint.h>
+
+// Figures for the job being printed, reported as one line when it ends so
+// that a host can gather throughput across printers:
+//
+// telemetry job=NAME wall_ms=N moving_ms=N firing_ms=N sd_ms=N serial_ms=N
+//     bytes=N records=N firings=N firings_per_s=N steps=N steps_per_s=N
+//     late_steps=N underruns=N brownouts=N
+//
+// all on one line. Fields may be added on the end.
+//
+// Build with TELEMETRY=0 to leave it out, counters and all; the report
+// line is then not sent.
+//
+//   make TELEMETRY=0
+
+#ifndef TELEMETRY
+#define TELEMETRY 1
+#endif
+
+// Milliseconds with the microseconds carried, so long jobs don't overflow
+struct TimeTotal {
+    uint32_t ms;
+    uint16_t us;
+};
+
+struct JobTelemetry {
+    uint32_t start_ms;
+    TimeTotal moving;       // steps taken back to back
+    TimeTotal firing;       // fire_head() and columns, with recovery
+    TimeTotal sd;           // block reads from the card
+    TimeTotal serial;       // waiting for recv data
+    uint32_t bytes;
+    uint32_t records;       // job lines parsed
+    uint32_t firings;       // pulses with a primitive on
+    uint32_t steps;
+    uint16_t underruns;     // blocks the head ran out of moves waiting for
+    uint16_t brownouts;     // drops of the primitive supply
+};
+
+#if TELEMETRY
+
+extern JobTelemetry telemetry;
+
+void time_total_add(TimeTotal *total, uint32_t us);
+
+void telemetry_start(void);
+void telemetry_step(uint32_t interval_us, bool continuing);
+void telemetry_report(const char *job, uint32_t bytes, uint32_t late_steps);
+
+#else
+
+static inline void telemetry_start(void) {
+}
+
+static inline void telemetry_step(uint32_t /*interval_us*/,
+                                  bool /*continuing*/) {
+}
+
+static inline void telemetry_report(const char * /*job*/,
+                                    uint32_t /*bytes*/,
+                                    uint32_t /*late_steps*/) {
+}
+
+#endif
+
+#endif
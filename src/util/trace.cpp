@@ -0,0 +1,99 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "trace.h"
+
+#include <Arduino.h>
+
+#include "hal.h"
+
+#if TRACE_EVENTS
+
+static TraceEvent events[TRACE_EVENTS];
+static uint8_t next_event = 0;
+static bool wrapped = false;
+static bool paused = false;
+
+void trace(uint8_t type, uint8_t a, uint16_t b) {
+    uint8_t state = hal_irq_save();
+
+    if(!paused) {
+        TraceEvent *event = &events[next_event];
+
+        event->us = micros();
+        event->type = type;
+        event->a = a;
+        event->b = b;
+
+        if(++next_event == TRACE_EVENTS) {
+            next_event = 0;
+            wrapped = true;
+        }
+    }
+
+    hal_irq_restore(state);
+}
+
+void trace_dump(void) {
+    paused = true;
+
+    uint8_t first = wrapped ? next_event : 0;
+    uint8_t count = wrapped ? TRACE_EVENTS : next_event;
+
+    Serial.print(F("trace "));
+    Serial.println(count);
+
+    for(uint8_t i = 0; i < count; i++) {
+        uint8_t index = (first + i) % TRACE_EVENTS;
+
+        Serial.write((const uint8_t *)&events[index], sizeof(TraceEvent));
+    }
+
+    paused = false;
+}
+
+void trace_reset(void) {
+    uint8_t state = hal_irq_save();
+
+    next_event = 0;
+    wrapped = false;
+
+    hal_irq_restore(state);
+}
+
+uint16_t trace_bytes(void) {
+    return sizeof(events);
+}
+
+#else
+
+void trace_dump(void) {
+    Serial.println(F("trace 0"));
+}
+
+void trace_reset(void) {
+}
+
+uint16_t trace_bytes(void) {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+    Argentum Firmware
+
+    Copyright (C) 2013 Isabella Stevens
+    Copyright (C) 2014 Michael Shiel
+    Copyright (C) 2015 Trent Waddington
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <stdint.h>
+
+// A ring of the last TRACE_EVENTS things the printer did, with the time
+// they happened, kept in RAM as they go so that a print that went wrong can
+// be looked at afterwards. trace dumps the ring to the host in binary,
+// tracedump.py turns that into a timeline. Recording an event is a few
+// stores with interrupts held off. Build with TRACE_EVENTS=0 to leave it
+// out: trace() is then an empty inline and its callers pay nothing.
+//
+//   make TRACE_EVENTS=0
+
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS 64
+#endif
+
+enum TraceType {
+    TRACE_NONE,
+    TRACE_MOVE_START,   // axis, position it is moving to
+    TRACE_MOVE_END,     // axis, position reached
+    TRACE_FIRE,         // fire_head(): address (right << 4 | left),
+                        // right << 8 | left primitives
+    TRACE_SD_READ,      // bits 16-23 and 0-15 of the block number
+    TRACE_LIMIT,        // axis, position where a limit stopped it
+    TRACE_BROWNOUT,     // 0, primitive voltage in hundredths of a volt
+    TRACE_COMMAND,      // first character, next two characters
+    TRACE_COLUMN        // fire_column(): addresses fired, bit per slot
+};
+
+// Little endian on the wire, as it is in memory on the AVR
+struct TraceEvent {
+    uint32_t us;        // micros()
+    uint8_t type;
+    uint8_t a;
+    uint16_t b;
+};
+
+#if TRACE_EVENTS
+
+void trace(uint8_t type, uint8_t a, uint16_t b);
+
+#else
+
+static inline void trace(uint8_t /*type*/, uint8_t /*a*/, uint16_t /*b*/) {
+}
+
+#endif
+
+// Sends "trace N" and a newline, then the N events oldest first as raw
+// bytes. Nothing is recorded while that goes out.
+void trace_dump(void);
+void trace_reset(void);
+
+uint16_t trace_bytes(void);
+
+#endif
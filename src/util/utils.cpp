@@ -24,15 +24,114 @@
 #include "settings.h"
 #include "logging.h"
 #include "limit.h"
+#include "telemetry.h"
+#include "trace.h"
 
 #include "../argentum/argentum.h"
 
+#ifdef __AVR__
+
+extern uint8_t __data_start, __data_end, __bss_start, __bss_end;
+extern uint8_t __heap_start, *__brkval;
+
+static uint8_t * heap_end(void) {
+    return __brkval == 0 ? &__heap_start : __brkval;
+}
+
 int ram_used(void) {
-  extern int __heap_start, *__brkval;
   int v;
-  return (int) &v - (__brkval == 0 ? (int) &__heap_start : (int) __brkval);
+  return (int) &v - (int) heap_end();
+}
+
+// Bytes left between the paint and the stack pointer by stack_repaint(),
+// room for the frames of whoever is calling it.
+#define STACK_REPAINT_MARGIN 32
+
+// Runs in .init3, after the stack pointer is set up and before .data and
+// .bss are initialised, so nothing above __heap_start is in use yet.
+void stack_paint(void) __attribute__((naked, used, section(".init3")));
+
+void stack_paint(void) {
+    for(uint8_t *p = &__heap_start; p <= (uint8_t *) RAMEND; p++) {
+        *p = STACK_PAINT;
+    }
 }
 
+void stack_repaint(void) {
+    uint8_t *top = (uint8_t *) SP - STACK_REPAINT_MARGIN;
+
+    for(uint8_t *p = heap_end(); p < top; p++) {
+        *p = STACK_PAINT;
+    }
+}
+
+uint16_t stack_unused(void) {
+    uint8_t *p = heap_end();
+
+    while(p <= (uint8_t *) RAMEND && *p == STACK_PAINT) {
+        p++;
+    }
+
+    return p - heap_end();
+}
+
+uint16_t stack_peak(void) {
+    return RAMEND + 1 - (uint16_t) heap_end() - stack_unused();
+}
+
+uint16_t stack_current(void) {
+    return RAMEND - SP;
+}
+
+uint16_t heap_used(void) {
+    return heap_end() - &__heap_start;
+}
+
+uint16_t static_data(void) {
+    return &__data_end - &__data_start;
+}
+
+uint16_t static_bss(void) {
+    return &__bss_end - &__bss_start;
+}
+
+#else
+
+// Off the printer there is no 8 KB budget to account for.
+
+int ram_used(void) {
+    return 0;
+}
+
+void stack_repaint(void) {
+}
+
+uint16_t stack_unused(void) {
+    return 0;
+}
+
+uint16_t stack_peak(void) {
+    return 0;
+}
+
+uint16_t stack_current(void) {
+    return 0;
+}
+
+uint16_t heap_used(void) {
+    return 0;
+}
+
+uint16_t static_data(void) {
+    return 0;
+}
+
+uint16_t static_bss(void) {
+    return 0;
+}
+
+#endif
+
 int ram_free(void) {
     return RAM_TOTAL - ram_used();
 }
@@ -73,33 +172,33 @@ void print_switch_status(uint8_t switches) {
     //Serial.print("Switch binary: ");
     //Serial.println(switches, BIN);
 
-    LoggerWrapper &info = logger.info() << "Limits: ";
+    LoggerWrapper<Logger::Info> &info = logger.info() << F("Limits: ");
 
     if(switches == 0b00000000) {
-        info << "None triggered.";
+        info << F("None triggered.");
     }
 
     if(X_POS(switches)) {
-        info << "X+ ";
+        info << F("X+ ");
     }
 
     if(X_NEG(switches)) {
-        info << "X- ";
+        info << F("X- ");
     }
 
     if(Y_POS(switches)) {
-        info << "Y+ ";
+        info << F("Y+ ");
     }
 
     if(Y_NEG(switches)) {
-        info << "Y- ";
+        info << F("Y- ");
     }
 
     info << Comms::endl;
 
     if((X_POS(switches) && X_NEG(switches))
         || (Y_POS(switches) && Y_NEG(switches))) {
-            logger.info("Impossible configuration on limit switches, inverting.");
+            logger.info(F("Impossible configuration on limit switches, inverting."));
 
             limit_switch_nc = !limit_switch_nc;
     }
@@ -150,5 +249,19 @@ double primitive_voltage(void) {
 }
 
 bool no_power(void) {
-    return primitive_voltage() < 5.0;
+    static bool was_off = false;
+
+    double volts = primitive_voltage();
+    bool off = volts < 5.0;
+
+    if(off && !was_off) {
+#if TELEMETRY
+        telemetry.brownouts++;
+#endif
+        trace(TRACE_BROWNOUT, 0, volts * 100);
+    }
+
+    was_off = off;
+
+    return off;
 }
@@ -30,6 +30,22 @@ int ram_free(void);
 int ram_used(void);
 double ram_utilisation(void);
 
+// Free RAM between the heap and the stack is filled with STACK_PAINT before
+// constructors run, so the deepest the stack has reached can be read back
+// later by looking for the first overwritten byte.
+#define STACK_PAINT 0xC5
+
+// Paint again from the top of the heap up to just below the current stack,
+// to measure the peak of whatever runs next.
+void stack_repaint(void);
+uint16_t stack_peak(void);
+uint16_t stack_current(void);
+uint16_t stack_unused(void);
+
+uint16_t heap_used(void);
+uint16_t static_data(void);
+uint16_t static_bss(void);
+
 uint8_t CRC8(const void *buffer, const uint16_t length);
 uint8_t CRC8_add_byte(uint8_t data, uint8_t seed_crc);
 
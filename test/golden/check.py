@@ -0,0 +1,225 @@
+#!/usr/bin/python
+
+# Golden trace regression test for printing. Every job in jobs/ is run on
+# the simulated printer (argentum-sim) each way it can reach the head:
+#
+#   card     .hex printed from the card by readFile()
+#   online   .hex streamed with recv o, run by onlinePrint()
+#   online   .b streamed with recv bo, through decb() and onlinePrint()
+#   card     .b sent to the card with recv b, decompressed, then printed
+#
+# The steps and firings, without their times, have to match expected/ to
+# the byte. A change that only makes printing faster passes, one that moves
+# or changes a single firing doesn't. Run with -u to accept new output.
+# The times are only checked for Y keeping to its acceleration ramp.
+
+import sys, os, getopt, subprocess, tempfile, difflib
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+JOBS = os.path.join(HERE, "jobs")
+EXPECTED = os.path.join(HERE, "expected")
+
+def recvStream(data, mode):
+    # recv's framing: a block of up to 1024 bytes, then the running djb2 of
+    # the whole file in five 7 bit groups
+    out = ("recv %d %s\n" % (len(data), mode)).encode()
+    h = 5381
+    for i in range(0, len(data), 1024):
+        block = data[i:i + 1024]
+        for c in bytearray(block):
+            h = (h * 33 + c) & 0xffffffff
+        out += block + bytes(bytearray([h & 0x7f, (h >> 7) & 0x7f,
+            (h >> 14) & 0x7f, (h >> 21) & 0x7f, (h >> 28) & 0x0f]))
+    return out
+
+def cardName(name):
+    return os.path.splitext(name)[0].upper() + ".HEX"
+
+def cases(name):
+    data = open(os.path.join(JOBS, name), "rb").read()
+    if name.endswith(".hex"):
+        yield "card", ("p %s\n" % cardName(name)).encode()
+        yield "online", recvStream(data, "o")
+    elif name.endswith(".b"):
+        yield "online", recvStream(data, "bo")
+        # Under a name the card doesn't have yet
+        target = "_" + cardName(name)[:7]
+        yield "card", (recvStream(data, "b " + target) +
+                       ("p %s\n" % target).encode())
+
+# Where the carriage starts, in steps from the negative limits
+START = {"X": 1000, "Y": 1000}
+
+def normalise(trace):
+    # Runs of steps one way on one axis become "<axis> <from> <to>",
+    # firings stay as they are, and times go.
+    out = []
+    position = dict(START)
+    run = None
+    for line in trace.splitlines():
+        if line.startswith("#"):
+            continue
+        fields = line.split()
+        if fields[1] in ("X", "Y"):
+            axis, to = fields[1], int(fields[2])
+            way = to - position[axis]
+            if not run or run[0] != axis or run[3] != way:
+                if run:
+                    out.append("%s %d %d" % tuple(run[:3]))
+                run = [axis, position[axis], to, way]
+            run[2] = to
+            position[axis] = to
+            continue
+        if run:
+            out.append("%s %d %d" % tuple(run[:3]))
+            run = None
+        out.append(" ".join(fields[1:]))
+    if run:
+        out.append("%s %d %d" % tuple(run[:3]))
+    return "\n".join(out) + "\n"
+
+# Axis::run() ramps the speed up from MIN_SPEED over the first RAMP_STEPS
+# steps of a move and down over the last, or over half of a move that is
+# shorter. Printing keeps Y at Y_SPEED (mm/min) otherwise. Speeds become
+# step intervals the way Stepper::set_speed() works them out.
+RAMP_STEPS = 100
+MIN_SPEED = 100
+Y_SPEED = 1500
+STEPS_PER_MM = 80
+
+def stepDelay(speed):
+    return 1000000 // (speed * STEPS_PER_MM // 60)
+
+# Longer than any step on a ramp, so Y stood still in between
+STOPPED = 2 * stepDelay(MIN_SPEED)
+
+def strokes(trace):
+    # Times of the steps of each run of Y steps one way without a stop
+    position = START["Y"]
+    run, way = [], 0
+    for line in trace.splitlines():
+        if line.startswith("#"):
+            continue
+        fields = line.split()
+        if fields[1] == "X" and run:
+            yield run
+            run, way = [], 0
+        if fields[1] != "Y":
+            continue
+        to, now = int(fields[2]), int(fields[0])
+        if run and (to - position != way or now - run[-1] > STOPPED):
+            yield run
+            run = []
+        way = to - position
+        position = to
+        run.append(now)
+    if run:
+        yield run
+
+def off_ramp(trace):
+    # No Y step may come sooner than the ramp allows for how far it is from
+    # the start and from the end of its stroke
+    for run in strokes(trace):
+        ramp = min(RAMP_STEPS, len(run) // 2)
+        for step in range(1, len(run)):
+            speed = Y_SPEED
+            for steps in (step, len(run) - step):
+                if steps < ramp:
+                    speed = min(speed, MIN_SPEED +
+                                (steps + 1) * (Y_SPEED - MIN_SPEED) // ramp)
+            if run[step] - run[step - 1] < stepDelay(speed):
+                return ("Y step at %d us of a %d step stroke came after %d us, "
+                        "the ramp allows %d" % (run[step], len(run),
+                        run[step] - run[step - 1], stepDelay(speed)))
+    return None
+
+def simulate(sim, card, stream):
+    trace = tempfile.NamedTemporaryFile(suffix=".trace", delete=False)
+    trace.close()
+    try:
+        run = subprocess.Popen([sim, "-d", card, "-t", trace.name,
+                                "-o", "%d,%d" % (START["X"], START["Y"])],
+                               stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                               stderr=subprocess.PIPE)
+        output, summary = run.communicate(stream)
+        events = open(trace.name).read()
+    finally:
+        os.unlink(trace.name)
+    seconds = 0.0
+    for line in summary.decode("utf-8", "ignore").splitlines():
+        if line.startswith("time "):
+            seconds = float(line.split()[1])
+    return run.returncode, events, seconds, output
+
+def main(argv):
+    try:
+        opts, args = getopt.getopt(argv, "uvh", ["update", "verbose", "help"])
+    except getopt.GetoptError:
+        print("check -h for help.")
+        sys.exit(2)
+
+    update = False
+    verbose = False
+    for opt, arg in opts:
+        if opt in ("-h", "--help"):
+            print("usage: check [-u] [-v] path/to/argentum-sim [job ...]")
+            print("  -u  write the output as the new expected traces")
+            print("  -v  show the firmware's serial output on failure")
+            sys.exit(0)
+        elif opt in ("-u", "--update"):
+            update = True
+        elif opt in ("-v", "--verbose"):
+            verbose = True
+
+    if len(args) < 1:
+        print("check -h for help.")
+        sys.exit(2)
+
+    sim = os.path.abspath(args[0])
+    names = args[1:] or sorted(n for n in os.listdir(JOBS)
+                               if n.endswith(".hex") or n.endswith(".b"))
+
+    failed = 0
+    for name in names:
+        for mode, stream in cases(name):
+            case = "%s.%s" % (name, mode)
+            code, events, seconds, output = simulate(sim, JOBS, stream)
+            result = normalise(events)
+            golden = os.path.join(EXPECTED, case + ".trace")
+
+            if update:
+                open(golden, "w").write(result)
+                status = "updated"
+            elif code != 0:
+                status = "FAILED, exit status %d" % code
+            elif not os.path.exists(golden):
+                status = "FAILED, no expected trace"
+            elif off_ramp(events):
+                status = "FAILED"
+                print("    " + off_ramp(events))
+            else:
+                expected = open(golden).read()
+                if expected == result:
+                    status = "ok"
+                else:
+                    status = "FAILED"
+                    diff = difflib.unified_diff(expected.splitlines(),
+                                                result.splitlines(),
+                                                "expected", "now",
+                                                lineterm="", n=2)
+                    for line in list(diff)[:40]:
+                        print("    " + line)
+
+            print("%-28s %-26s %9.3f s" % (case, status, seconds))
+            if status.startswith("FAILED"):
+                failed += 1
+                if verbose:
+                    sys.stdout.write(output.decode("utf-8", "ignore"))
+
+    if failed:
+        print("%d failed." % failed)
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
+    sys.exit(0)
@@ -0,0 +1,244 @@
+z,02,z,,zC3,z,,,,z01,z,,
+2
+d
+2
+d
+2
+d
+2
+d
+2
+,,,,,,,,,,,,
+2
+,,,,,,,,,,,,08
+2
+z,,,,,,,,,,,,p
+2
+11,z,,,,z20,z,a,c,z,,1108,zr
+2
+z,,,z10,z,,,,,,,,
+2
+FF,z,,,,p,z,,,,zc,z,za
+2
+d
+2
+d
+2
+d
+2
+d
+2
+z,,,,,40,z,,a,z,zb,z,
+2
+zb,z,zs,s,80,z,,,zq,z,za,zy,z
+2
+za,z,zr,r,y,z,,,zq,z,za,zy,z
+2
+,,,,,,zp,q,z,,,zr,z
+2
+,,,,,,,,,,,,r
+2
+z,,,,,,,zy,z,,x,z,
+2
+d
+2
+,,,,,,,b,z,p,z,,c
+2
+z,,,zy,z,zs,zb,z,,,,zq,z
+2
+,za,z,,zb,z,,,,,y,z,
+2
+,,,,,,,,,,,,
+2
+,zr,z,,,,zq,za,z,,,,
+2
+d
+2
+d
+2
+d
+2
+d
+2
+,,,,04,x,z,,,,,,
+2
+,,,zb,z,,,,,,w,c,z
+2
+d
+2
+d
+2
+d
+2
+zr,z,,,,,zn,z,,,,,
+2
+d
+2
+d
+2
+,,b,z,,,zr,z,zy,z,,n,zn
+2
+z,,c,z,,,,,,,,,
+2
+,,,,,,,,,,,,
+2
+d
+2
+za,z,,,,zo,z,,,,x,z,
+2
+,,,,c,z,,,,zr,,zw,z
+2
+d
+2
+,,,80C3,z,,,,c,zr,z,,
+2
+,,,,zp,z,,zc,r,z,,zp,z
+2
+n,z,p,zn,z,zq,z,,,,,o,z
+2
+,,,,,,,,,zw,zq,zr,z
+2
+d
+2
+,,,,,,,,,zw,z,,
+2
+d
+2
+d
+2
+,,,,,,zo,x,p,z,,,
+2
+d
+2
+,,zw,z,,,,,,,,,
+2
+d
+2
+d
+2
+,,,,,,,,,,zb,z,
+2
+-120
+X-150
+p,z,,,,,y,z,,,,y,z
+2
+,n,z,,,,,o,z,,,,r
+2
+z,n,z,,,,,o,z,,,,r
+2
+z,,c,zb,z,,,,n,z,zy,z,zp
+2
+z,,,,,,,,,,zp,z,
+2
+zb,z,,,,,,,,4002,z,w,z
+2
+,,,,,,,,,,,,
+2
+,,,,,,,zp,z,zr,w,z,
+2
+,,,zo,z,zx,z,,,zp,z,,
+2
+d
+2
+,,zy,zb,z,p,z,,,,za,z,
+2
+d
+2
+d
+2
+d
+2
+d
+2
+,,,,,,q,zc,z,,,,zc
+2
+z,,,,,,q,zc,z,,,,zc
+2
+d
+2
+z,,,o,z,,,,,,,,
+2
+d
+2
+,b,z,,,,,,za,n,z,,zb
+2
+z,,a,z,zq,z,,,,c,z,,zo
+2
+d
+2
+z,,,,zq,z,,,,,,,
+2
+,,,zc,z,,,,,,,r,z
+2
+,zn,q,z,,,,,,n,z,,
+2
+d
+2
+,,x,z,,,za,z,,,zn,z,
+2
+,20C3,z,,,,,,,,a,z,
+2
+,,zy,z,,,,p,z,,,,
+2
+,,,,,w,z,,,,,zy,z
+2
+d
+2
+,,,,,,a,z,,,zn,z,
+2
+,,x,z,,,,,,,zr,z,
+2
+b,z,,,,,,,,,,,
+2
+,,,,,,,,,,,,
+2
+d
+2
+,zr,,z,,,,r,z,y,z,,zw
+2
+z,zr,,z,,,,r,z,y,z,,zw
+2
+z,,,,,,,,,,r,z,
+2
+,,,,,,,,,,x,z,
+2
+,,,,,,,,zw,r,z,zw,z
+2
+,,,,,,,,,,r,z,o
+2
+z,,,,,,,,,,,,a
+2
+z,zo,z,,,,o,z,,,,,
+2
+d
+2
+,,,,,zp,z,,,,,,
+2
+w,z,,,,w,c,z,,,,zx,zy
+2
+d
+2
+d
+2
+z,,,,,q,z,,,zx,q,a,z
+2
+,,,40FF,z,zr,z,,,,,zc,z
+2
+,,,,zo,z,,,,,,,
+2
+,a,z,,,,zr,z,,,,,
+2
+,,,w,b,z,,zq,z,,,,
+2
+,,zb,z,,,,,,,,,
+2
+zn,z,zo,z,,,zw,z,,,,zo,z
+2
+,,,,,,,,,,,zp,q
+2
+z,,,,,,,,zq,z,b,a,z
+2
+zc,z,,,p,z,,,,,,,
+2
+-120
+X-150
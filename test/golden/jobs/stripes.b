@@ -0,0 +1,246 @@
+0280,z40,z01,z11,z80,0802,zb,za,z,zd,z20,08,z
+2
+,C3,ze,z,40C3,1080,zc,za,04C3,zg,0440,0110,z
+2
+0408,z,FFFF,1110,z,zFF,,0120,f,2001,c,1108,z04
+2
+z,zg,0110,02,1004,i,ze,0240,0810,zf,zb,4004,h
+2
+g,0801,c,z10,f,0210,zk,h,f,i,z,zf,0840
+2
+C3FF,e,1008,z,0408,j,zg,FF01,04FF,e,ze,f,z
+2
+h,4004,zc,40FF,j,1002,1001,zg,4001,1102,C302,a,1080
+2
+2001,z,za,0220,z,f,z,ze,FF08,j,8011,z,1004
+2
+z,2011,1108,0810,j,0120,0420,C304,z,j,z,0801,z
+2
+zf,4001,z,j,40FF,FF40,zd,g,ze,1110,zc,1180,FFC3
+2
+z,2080,z,c,zg,j,zh,z,k,8002,z,0440,c
+2
+a,h,0102,z,j,c,z,f,4020,c,zc,j,a
+2
+d
+2
+d
+2
+g,1010,0811,z,0480,j,4002,zc,zg,z,FF10,C3FF,0280
+2
+e,zg,zh,k,z,zd,zk,zg,20C3,a,1102,f,z
+2
+,,,,k,C304,1080,1011,2080,h,0210,zf,2002
+2
+z,h,g,ze,zh,d,zf,c,zc,a,10C3,z,c
+2
+zh,i,k,f,0220,j,1108,zh,z,zk,0440,8004,zk
+2
+0810,1108,zb,za,zf,C301,i,1104,g,zb,0410,zf,C310
+2
+z,C310,zb,1140,zh,z,FFFF,C310,z,zj,f,zj,zh
+2
+,C340,z,FF10,zb,zk,0440,z,a,0820,a,0280,h
+2
+zk,za,0204,01C3,4020,FFFF,e,2080,ze,z,,,FF10
+2
+z,C310,2004,k,0240,z,,,j,,zi,4020,zk
+2
+d
+2
+d
+2
+zd,zf,z,,08FF,zd,c,zb,8010,z,1020,zc,za
+2
+z,C380,FF04,0401,z,2010,z,,,8020,z,zj,0401
+2
+zi,k,FF40,zd,d,4004,0401,0402,i,c,0820,g,h
+2
+z,zb,z,4080,FF40,8040,z,10FF,d,z,,zg,10C3
+2
+z,1008,0440,c,1140,d,0811,2004,zd,01FF,z,,8002
+2
+d
+2
+d
+2
+d
+2
+d
+2
+zg,1111,ze,b,zf,g,c,0204,i,0202,0801,0240,g
+2
+d
+2
+e,g,10C3,FF40,4008,zb,zf,4001,k,0402,zh,h,z
+2
+d
+2
+zc,0820,1040,zc,k,z,b,zh,zb,za,2011,0201,z
+2
+-80
+X100
+zh,2011,z,,11FF,z,b,20C3,z,4020,2008,zb,j
+2
+d
+2
+e,1108,0408,e,f,80C3,z,8002,k,4001,z,a,zi
+2
+d
+2
+1040,z,za,zf,z,zf,h,zc,0801,z,,zf,80C3
+2
+d
+2
+d
+2
+d
+2
+FF01,1040,i,zh,z,za,z,1004,k,z,zi,1010,0104
+2
+j,0808,FF08,02C3,40C3,11FF,f,,zi,04FF,h,8011,1180
+2
+d
+2
+d
+2
+i,za,zf,4008,zh,1101,z,zg,1101,z,za,z,10C3
+2
+FF01,a,e,g,z,0408,ze,e,0201,1104,z,1111,a
+2
+ze,0180,1020,zh,zc,z,h,02FF,2020,ze,d,FFFF,zi
+2
+i,02FF,e,z,j,k,1011,i,zi,C308,80FF,f,2010
+2
+d,ze,i,c,zi,zj,1110,0180,c,C380,k,f,04FF
+2
+d
+2
+FF40,zc,g,zc,0102,zc,,j,h,z,h,zc,z
+2
+k,c,FF10,b,2080,d,z,4002,01FF,zb,1001,02C3,z
+2
+d
+2
+,g,h,za,h,z,zf,z,za,1110,z,C380,0420
+2
+FF11,C3FF,zk,z,f,z,ze,zc,FF10,z,b,0101,2001
+2
+8010,FF08,a,h,2001,h,zi,0220,zd,b,zj,f,0802
+2
+d
+2
+z,zf,z,ze,g,C340,z,e,zj,zk,e,8020,
+2
+d
+2
+d
+2
+z,d,0411,e,8040,e,z,zi,b,ze,,z,
+2
+4010,z,zk,4001,k,j,h,0811,h,z,zh,h,0208
+2
+0880,b,f,zg,z,g,zd,b,2002,g,k,zd,02C3
+2
+i,k,,01C3,0211,e,zk,z,2020,c,8080,zg,02FF
+2
+e,zd,40FF,zc,b,20C3,zj,2004,b,0480,f,zi,a
+2
+d
+2
+d
+2
+i,zf,40FF,04FF,zf,i,za,C304,zh,0802,4040,8011,f
+2
+k,zc,01C3,FF20,0280,40FF,4040,z,ze,i,f,zj,8020
+2
+za,8010,zk,8004,FF20,d,C311,c,a,zh,c,e,zb
+2
+c,zk,za,,z,c,j,f,4020,a,i,40C3,zk
+2
+04FF,0411,4020,z,zb,0480,b,FF04,0420,zb,f,b,k
+2
+-80
+X100
+d
+2
+z,4080,z,C310,e,za,h,0401,4011,02FF,a,i,z
+2
+zb,i,1102,zg,i,0480,zc,80FF,h,zc,40FF,2002,c
+2
+j,C301,0880,zh,C311,1108,e,zb,i,1004,C3C3,z,40C3
+2
+d
+2
+d
+2
+j,k,10FF,z,zc,zi,zf,z,80C3,h,0220,z,
+2
+zc,zi,j,FF08,0408,e,zc,c,1101,k,02C3,g,z
+2
+zi,z,0180,0804,z,0211,1010,z,,b,h,d,z
+2
+0280,04C3,z,za,,zi,a,zk,4002,04FF,z,zg,ze
+2
+zj,4011,z,4008,a,0201,zc,0101,20FF,e,zg,FF11,f
+2
+k,10C3,g,f,4004,z,,a,0140,z,f,C302,0880
+2
+b,4008,1011,1020,0101,z,0880,zg,zf,zc,z,0180,h
+2
+d
+2
+d
+2
+d
+2
+d
+2
+FF40,10FF,40FF,0280,i,0120,2040,zh,zb,40FF,0110,z,zc
+2
+d
+2
+z,0801,zk,j,1104,zd,z,,ze,8020,1180,4011,c
+2
+d
+2
+zb,1180,z,,FF20,zc,c,0410,z,40FF,1011,C304,0220
+2
+z,,,80C3,0110,FFC3,d,0801,FF04,za,20FF,zb,zk
+2
+zb,z,FF80,0140,40FF,h,za,ze,za,10FF,FF01,za,1101
+2
+d
+2
+0204,80C3,0101,C311,e,z,0280,4040,0401,e,c,04C3,0808
+2
+g,zi,ze,zj,0840,1111,z,zc,i,d,0210,80FF,C340
+2
+zj,zg,z,01C3,z,zc,FF40,z,C3C3,za,z,zh,2001
+2
+d
+2
+11C3,1110,11C3,4011,0480,h,zg,c,4001,z,g,0201,z
+2
+zi,0802,j,0240,2040,z,zc,0411,h,0402,z,b,80C3
+2
+d
+2
+d
+2
+z,zj,z,g,0180,a,0208,1108,zd,0420,1110,k,0808
+2
+b,zd,1002,0480,z,zk,2010,0410,z,0104,zf,e,0801
+2
+e,c,a,e,z,1120,z,h,f,1011,4011,d,02C3
+2
+z,k,z,04C3,8020,0810,1110,1020,zg,g,i,0220,1002
+2
+zb,1140,zj,b,k,za,0480,h,za,zf,1111,h,C3C3
+2
+d
+2
+d,za,0110,zk,z,k,1004,4011,b,1008,C340,0140,z
+2
+-80
+X100
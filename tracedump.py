@@ -0,0 +1,101 @@
+#!/usr/bin/python
+
+# Shows the printer's event trace as a timeline. With no arguments it asks
+# the printer for it, otherwise it reads what was captured from the serial
+# line into a file, e.g. from the simulator:
+#
+#   echo trace | ./argentum-sim -d jobs -p JOB.HEX > out
+#   ./tracedump.py out
+
+import sys
+import struct
+import time
+
+EVENT = struct.Struct("<IBBH")
+
+def axis(a):
+    return chr(a)
+
+def describe(kind, a, b):
+    if kind == 1:
+        return "move   %s to %d" % (axis(a), b)
+    if kind == 2:
+        return "moved  %s at %d" % (axis(a), b)
+    if kind == 3:
+        return "fire   address %X/%X primitives %02X/%02X" % (
+            a >> 4, a & 0x0F, b >> 8, b & 0xFF)
+    if kind == 4:
+        return "sd     block %d" % ((a << 16) | b)
+    if kind == 5:
+        return "limit  %s at %d" % (axis(a), b)
+    if kind == 6:
+        return "power  dropped to %.2fV" % (b / 100.0)
+    if kind == 7:
+        name = chr(a) + chr(b & 0xFF) + chr(b >> 8)
+        return "cmd    %s" % name.rstrip("\0")
+    if kind == 8:
+        slots = [str(slot) for slot in range(16) if b & (1 << slot)]
+        return "column %d addresses, slots %s" % (a, " ".join(slots))
+    return "?%d    %d %d" % (kind, a, b)
+
+def decode(data):
+    start = data.rfind(b"trace ")
+    if start == -1:
+        return None
+
+    end = data.find(b"\n", start)
+    count = int(data[start + 6:end].strip())
+    body = data[end + 1:]
+
+    if len(body) < count * EVENT.size:
+        return None
+
+    return [EVENT.unpack_from(body, i * EVENT.size) for i in range(count)]
+
+def fetch():
+    from serial import Serial
+    from send import findPort
+
+    port = findPort()
+    if port == None:
+        print("can't find the printer.")
+        sys.exit(1)
+
+    serialDevice = Serial(port, 115200, timeout=0.5)
+    serialDevice.write(b"trace\n")
+
+    data = b""
+    deadline = time.time() + 5
+    while time.time() < deadline:
+        data += serialDevice.read(4096)
+        events = decode(data)
+        if events is not None:
+            return events
+
+    print("no trace from the printer.")
+    sys.exit(1)
+
+def main(args):
+    if len(args) > 0:
+        with open(args[0], "rb") as f:
+            events = decode(f.read())
+        if events is None:
+            print("no trace in %s" % args[0])
+            sys.exit(1)
+    else:
+        events = fetch()
+
+    if not events:
+        print("trace is empty")
+        return
+
+    first = events[0][0]
+    last = first
+    for us, kind, a, b in events:
+        # micros() wraps after about 71 minutes
+        print("%12.3f ms %+10.3f  %s" % (((us - first) & 0xFFFFFFFF) / 1000.0,
+            ((us - last) & 0xFFFFFFFF) / 1000.0, describe(kind, a, b)))
+        last = us
+
+if __name__ == "__main__":
+    main(sys.argv[1:])